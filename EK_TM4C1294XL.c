@@ -75,39 +75,137 @@
 #include "I2CSlave.h"
 #include "I2CTivaSlave.h"
 
+/* Pin mux of an I2C module, on its first pin option */
+typedef struct EK_TM4C1294XL_I2CSlavePins {
+    uint32_t        periph;         /* SYSCTL_PERIPH_I2Cn */
+    uint32_t        gpioBase;       /* Port of the SCL and SDA pins */
+    uint32_t        sclPinConfig;   /* GPIO_Pxn_I2CnSCL */
+    uint32_t        sdaPinConfig;   /* GPIO_Pxn_I2CnSDA */
+    uint8_t         sclPin;
+    uint8_t         sdaPin;
+} EK_TM4C1294XL_I2CSlavePins;
+
+static const EK_TM4C1294XL_I2CSlavePins i2cSlavePins[] = {
+    {SYSCTL_PERIPH_I2C0, GPIO_PORTB_BASE, GPIO_PB2_I2C0SCL, GPIO_PB3_I2C0SDA,
+        GPIO_PIN_2, GPIO_PIN_3},
+    {SYSCTL_PERIPH_I2C1, GPIO_PORTG_BASE, GPIO_PG0_I2C1SCL, GPIO_PG1_I2C1SDA,
+        GPIO_PIN_0, GPIO_PIN_1},
+    {SYSCTL_PERIPH_I2C2, GPIO_PORTL_BASE, GPIO_PL1_I2C2SCL, GPIO_PL0_I2C2SDA,
+        GPIO_PIN_1, GPIO_PIN_0},
+    {SYSCTL_PERIPH_I2C3, GPIO_PORTK_BASE, GPIO_PK4_I2C3SCL, GPIO_PK5_I2C3SDA,
+        GPIO_PIN_4, GPIO_PIN_5},
+    {SYSCTL_PERIPH_I2C4, GPIO_PORTK_BASE, GPIO_PK6_I2C4SCL, GPIO_PK7_I2C4SDA,
+        GPIO_PIN_6, GPIO_PIN_7},
+    {SYSCTL_PERIPH_I2C5, GPIO_PORTB_BASE, GPIO_PB0_I2C5SCL, GPIO_PB1_I2C5SDA,
+        GPIO_PIN_0, GPIO_PIN_1},
+    {SYSCTL_PERIPH_I2C6, GPIO_PORTA_BASE, GPIO_PA6_I2C6SCL, GPIO_PA7_I2C6SDA,
+        GPIO_PIN_6, GPIO_PIN_7},
+    {SYSCTL_PERIPH_I2C7, GPIO_PORTD_BASE, GPIO_PD0_I2C7SCL, GPIO_PD1_I2C7SDA,
+        GPIO_PIN_0, GPIO_PIN_1},
+    {SYSCTL_PERIPH_I2C8, GPIO_PORTD_BASE, GPIO_PD2_I2C8SCL, GPIO_PD3_I2C8SDA,
+        GPIO_PIN_2, GPIO_PIN_3},
+    {SYSCTL_PERIPH_I2C9, GPIO_PORTA_BASE, GPIO_PA0_I2C9SCL, GPIO_PA1_I2C9SDA,
+        GPIO_PIN_0, GPIO_PIN_1},
+};
+
+/* I2C module number of each port */
+static const uint8_t i2cSlaveModules[EK_TM4C1294XL_I2CSLAVECOUNT] = {
+#define EK_TM4C1294XL_I2CSLAVE_MODULE(module, ringSize) module,
+    EK_TM4C1294XL_I2CSLAVE_PORTS(EK_TM4C1294XL_I2CSLAVE_MODULE)
+#undef EK_TM4C1294XL_I2CSLAVE_MODULE
+};
+
 I2CTivaSlave_Object i2cTivaSlaveObjects[EK_TM4C1294XL_I2CSLAVECOUNT];
-unsigned char i2cTivaSlaveRingBuffer[EK_TM4C1294XL_I2CSLAVECOUNT][32];
+
+#define EK_TM4C1294XL_I2CSLAVE_RINGBUF(module, ringSize) \
+    unsigned char i2cTivaSlaveRingBuffer##module[ringSize];
+EK_TM4C1294XL_I2CSLAVE_PORTS(EK_TM4C1294XL_I2CSLAVE_RINGBUF)
+#undef EK_TM4C1294XL_I2CSLAVE_RINGBUF
+
+#if I2CTIVASLAVE_USE_POOL
+/* Receive blocks used when an instance is opened in I2CSLAVE_MODE_POOL */
+I2CTivaSlave_PoolBlock i2cTivaSlavePoolBlocks[EK_TM4C1294XL_I2CSLAVECOUNT][4];
+unsigned char i2cTivaSlavePoolBuffer[EK_TM4C1294XL_I2CSLAVECOUNT][4][32];
+
+#define EK_TM4C1294XL_I2CSLAVE_POOL(module) \
+        .poolBlocks  = i2cTivaSlavePoolBlocks[EK_TM4C1294XL_I2CSLAVE##module], \
+        .poolBufPtr  = \
+            i2cTivaSlavePoolBuffer[EK_TM4C1294XL_I2CSLAVE##module][0], \
+        .poolBlockSize  = sizeof(i2cTivaSlavePoolBuffer[0][0]), \
+        .poolBlockCount = sizeof(i2cTivaSlavePoolBlocks[0]) / \
+            sizeof(i2cTivaSlavePoolBlocks[0][0]),
+#else
+#define EK_TM4C1294XL_I2CSLAVE_POOL(module)
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+/* Reply cache entries used when an instance is opened with replyCacheLifetime */
+I2CTivaSlave_CacheEntry i2cTivaSlaveReplyCache[EK_TM4C1294XL_I2CSLAVECOUNT][4];
+
+#define EK_TM4C1294XL_I2CSLAVE_REPLYCACHE(module) \
+        .replyCache = i2cTivaSlaveReplyCache[EK_TM4C1294XL_I2CSLAVE##module], \
+        .replyCacheCount = sizeof(i2cTivaSlaveReplyCache[0]) / \
+            sizeof(i2cTivaSlaveReplyCache[0][0]),
+#else
+#define EK_TM4C1294XL_I2CSLAVE_REPLYCACHE(module)
+#endif
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+/* General call frames shared by the ports opened with generalCall */
+I2CTivaSlave_Broadcast i2cTivaSlaveBroadcast;
+
+#define EK_TM4C1294XL_I2CSLAVE_BROADCAST \
+        .broadcast = &i2cTivaSlaveBroadcast,
+#else
+#define EK_TM4C1294XL_I2CSLAVE_BROADCAST
+#endif
 
 const I2CTivaSlave_HWAttrs i2cTivaSlaveHWAttrs[EK_TM4C1294XL_I2CSLAVECOUNT] = {
-    {
-        .baseAddr = I2C5_BASE,
-        .intNum = INT_I2C5,
-        .intPriority = (~0),
-        .ringBufPtr  = i2cTivaSlaveRingBuffer[0],
-        .ringBufSize = sizeof(i2cTivaSlaveRingBuffer[0])
-    }
+#define EK_TM4C1294XL_I2CSLAVE_HWATTRS(module, ringSize) \
+    { \
+        .baseAddr = I2C##module##_BASE, \
+        .intNum = INT_I2C##module, \
+        .intPriority = (~0), \
+        .ringBufPtr  = i2cTivaSlaveRingBuffer##module, \
+        .ringBufSize = sizeof(i2cTivaSlaveRingBuffer##module), \
+        EK_TM4C1294XL_I2CSLAVE_POOL(module) \
+        .periph = SYSCTL_PERIPH_I2C##module, \
+        EK_TM4C1294XL_I2CSLAVE_REPLYCACHE(module) \
+        EK_TM4C1294XL_I2CSLAVE_BROADCAST \
+    },
+    EK_TM4C1294XL_I2CSLAVE_PORTS(EK_TM4C1294XL_I2CSLAVE_HWATTRS)
+#undef EK_TM4C1294XL_I2CSLAVE_HWATTRS
 };
 
 const I2CSlave_Config I2CSlave_config[] = {
-    {
-        .fxnTablePtr = &I2CTivaSlave_fxnTable,
-        .object = &i2cTivaSlaveObjects[0],
-        .hwAttrs = &i2cTivaSlaveHWAttrs[0]
+#define EK_TM4C1294XL_I2CSLAVE_CONFIG(module, ringSize) \
+    { \
+        .fxnTablePtr = &I2CTivaSlave_fxnTable, \
+        .object = &i2cTivaSlaveObjects[EK_TM4C1294XL_I2CSLAVE##module], \
+        .hwAttrs = &i2cTivaSlaveHWAttrs[EK_TM4C1294XL_I2CSLAVE##module] \
     },
+    EK_TM4C1294XL_I2CSLAVE_PORTS(EK_TM4C1294XL_I2CSLAVE_CONFIG)
+#undef EK_TM4C1294XL_I2CSLAVE_CONFIG
     {NULL, NULL, NULL}
 };
 
 void EK_TM4C1294XL_initI2CSlave(void)
 {
-    /* I2C5 Init */
-    /* Enable the peripheral */
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_I2C5);
-
-    /* Configure the appropriate pins to be I2C instead of GPIO. */
-    GPIOPinConfigure(GPIO_PB0_I2C5SCL);
-    GPIOPinConfigure(GPIO_PB1_I2C5SDA);
-    GPIOPinTypeI2CSCL(GPIO_PORTB_BASE, GPIO_PIN_0);
-    GPIOPinTypeI2C(GPIO_PORTB_BASE, GPIO_PIN_1);
+    unsigned int                        i;
+    const EK_TM4C1294XL_I2CSlavePins   *pins;
+
+    for (i = 0; i < EK_TM4C1294XL_I2CSLAVECOUNT; i++) {
+        pins = &i2cSlavePins[i2cSlaveModules[i]];
+
+        /* Enable the peripheral */
+        SysCtlPeripheralEnable(pins->periph);
+
+        /* Configure the appropriate pins to be I2C instead of GPIO. */
+        GPIOPinConfigure(pins->sclPinConfig);
+        GPIOPinConfigure(pins->sdaPinConfig);
+        GPIOPinTypeI2CSCL(pins->gpioBase, pins->sclPin);
+        GPIOPinTypeI2C(pins->gpioBase, pins->sdaPin);
+    }
 
     I2CSlave_init();
 }
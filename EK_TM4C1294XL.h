@@ -50,12 +50,28 @@
 extern "C" {
 #endif
 
+/*!
+ *  @def    EK_TM4C1294XL_I2CSLAVE_PORTS
+ *  @brief  I2C modules used as I2CSlave ports, one PORT() line per port
+ *
+ *  PORT(module, ringSize): module is the number of the I2Cn peripheral
+ *  (0 to 9) and ringSize the size of its receive ring buffer. The
+ *  I2CSlave name, object, ring buffer, hardware attributes and pin setup of
+ *  every port are generated from this list. For example, adding
+ *  PORT(2, 64) creates EK_TM4C1294XL_I2CSLAVE2 on PL1 (SCL) / PL0 (SDA).
+ */
+#define EK_TM4C1294XL_I2CSLAVE_PORTS(PORT) \
+    PORT(5, 32)
+
 /*!
  *  @def    EK_TM4C1294XL_I2CSlaveName
  *  @brief  Enum of I2C names on the EK_TM4C1294XL dev board
  */
 typedef enum EK_TM4C1294XL_I2CSlaveName {
-    EK_TM4C1294XL_I2CSLAVE5 = 0,
+#define EK_TM4C1294XL_I2CSLAVE_NAME(module, ringSize) \
+    EK_TM4C1294XL_I2CSLAVE##module,
+    EK_TM4C1294XL_I2CSLAVE_PORTS(EK_TM4C1294XL_I2CSLAVE_NAME)
+#undef EK_TM4C1294XL_I2CSLAVE_NAME
 
     EK_TM4C1294XL_I2CSLAVECOUNT
 } EK_TM4C1294XL_I2CSlaveName;
@@ -20,10 +20,32 @@ static int I2CSlave_count = -1;
 
 /* Default I2CSlave parameters structure */
 const I2CSlave_Params I2CSlave_defaultParams = {
+    I2CSLAVE_MODE_BLOCKING,   /* readMode */
     I2CSLAVE_WAIT_FOREVER,    /* readTimeout */
     I2CSLAVE_WAIT_FOREVER,    /* writeTimeout */
     100,                      /* writePendingTimeout */
     0x1D,                     /* address */
+    false,                    /* frameTimestamps */
+    NULL,                     /* cmdTable */
+    0,                        /* cmdCount */
+    false,                    /* txPrestage */
+    false,                    /* rxBackpressure */
+    NULL,                     /* streamBufs */
+    0,                        /* streamBufCount */
+    0,                        /* streamBufSize */
+    0,                        /* packetLenOffset */
+    1,                        /* packetLenSize */
+    0,                        /* packetMaxSize */
+    0,                        /* writePendingPercentile */
+    1,                        /* writePendingMin */
+    1000,                     /* writePendingMax */
+    0,                        /* busWatchdog */
+    0,                        /* replyCacheLifetime */
+    false,                    /* generalCall */
+    false,                    /* generalCallSubscribe */
+    NULL,                     /* sinks */
+    0,                        /* sinkCount */
+    false,                    /* highSpeed */
 };
 
 /*
@@ -86,6 +108,57 @@ int I2CSlave_read(I2CSlave_Handle handle, void *buffer, size_t size)
     return (handle->fxnTablePtr->readFxn(handle, buffer, size));
 }
 
+/*
+ *  ======== I2CSlave_readTimestamp ========
+ */
+int I2CSlave_readTimestamp(I2CSlave_Handle handle, void *buffer, size_t size,
+                           uint32_t *timestamp)
+{
+    return (handle->fxnTablePtr->readTimestampFxn(handle, buffer, size,
+        timestamp));
+}
+
+/*
+ *  ======== I2CSlave_readBlock ========
+ */
+int I2CSlave_readBlock(I2CSlave_Handle handle, void **block)
+{
+    return (handle->fxnTablePtr->readBlockFxn(handle, block));
+}
+
+/*
+ *  ======== I2CSlave_readBroadcast ========
+ */
+int I2CSlave_readBroadcast(I2CSlave_Handle handle, void **frame)
+{
+    return (handle->fxnTablePtr->readBroadcastFxn(handle, frame));
+}
+
+/*
+ *  ======== I2CSlave_releaseBlock ========
+ */
+void I2CSlave_releaseBlock(I2CSlave_Handle handle, void *block)
+{
+    handle->fxnTablePtr->releaseBlockFxn(handle, block);
+}
+
+/*
+ *  ======== I2CSlave_releaseBroadcast ========
+ */
+void I2CSlave_releaseBroadcast(I2CSlave_Handle handle, void *frame)
+{
+    handle->fxnTablePtr->releaseBroadcastFxn(handle, frame);
+}
+
+/*
+ *  ======== I2CSlave_transact ========
+ */
+int I2CSlave_transact(I2CSlave_Handle handle, void *rxBuf, size_t rxLen,
+                      I2CSlave_CmdFxn responder)
+{
+    return (handle->fxnTablePtr->transactFxn(handle, rxBuf, rxLen, responder));
+}
+
 /*
  *  ======== I2CSlave_write ========
  */
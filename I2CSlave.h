@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #define I2CSLAVE_WAIT_FOREVER (~0)
 
@@ -26,11 +27,128 @@ typedef struct I2CSlave_Config      *I2CSlave_Handle;
 
 typedef void (*I2CSlave_Callback)    (I2CSlave_Handle, void *buf, size_t count);
 
+/*
+ *  Command handler called from the I2CSlave interrupt as soon as the opcode
+ *  and its argument bytes have been received. cmd holds the opcode followed
+ *  by the arguments. The handler writes the response into reply and returns
+ *  the number of bytes to send on the following master read. A reply the
+ *  master has not started to read is dropped at the next master write or
+ *  I2CSlave_write().
+ */
+typedef size_t (*I2CSlave_CmdFxn)    (I2CSlave_Handle handle,
+                                      const unsigned char *cmd, size_t cmdSize,
+                                      unsigned char *reply, size_t replySize);
+
+typedef struct I2CSlave_Cmd {
+    unsigned char     opcode;           /*!< First byte of the transaction */
+    unsigned char     argSize;          /*!< Argument bytes after the opcode */
+    I2CSlave_CmdFxn   cmdFxn;           /*!< Handler, runs in the ISR */
+} I2CSlave_Cmd;
+
+/*
+ *  Where a receive sink stage runs
+ */
+typedef enum I2CSlave_SinkLevel {
+    I2CSLAVE_SINK_ISR = 0,              /*!< In the I2CSlave interrupt */
+    I2CSLAVE_SINK_SWI                   /*!< In a Swi posted by the interrupt */
+} I2CSlave_SinkLevel;
+
+/*
+ *  Receive sink stage, called with each batch of received bytes in order.
+ *  The stage may change the count bytes of data in place; it returns the
+ *  number of bytes, left at the start of data, that go on to the next stage
+ *  and finally to the read mode: count to pass the batch on, 0 to consume
+ *  it. end is set on the last batch of a master write, which may be empty.
+ */
+typedef size_t (*I2CSlave_SinkFxn)   (I2CSlave_Handle handle, void *arg,
+                                      unsigned char *data, size_t count,
+                                      bool end);
+
+typedef struct I2CSlave_Sink {
+    I2CSlave_SinkFxn   sinkFxn;         /*!< Stage function */
+    void              *arg;             /*!< Passed to sinkFxn */
+    I2CSlave_SinkLevel level;           /*!< ISR stages must come first */
+} I2CSlave_Sink;
+
+/*
+ *  I2CSlave read modes
+ */
+typedef enum I2CSlave_ReadMode {
+    /*! I2CSlave_read() copies received bytes out of the ring buffer */
+    I2CSLAVE_MODE_BLOCKING = 0,
+
+    /*!
+     *  Each master write is received into a block of a fixed-size pool and
+     *  handed to the application by I2CSlave_readBlock(). The block must be
+     *  given back with I2CSlave_releaseBlock(), once; a second release or a
+     *  pointer that is not a block handed out is ignored.
+     */
+    I2CSLAVE_MODE_POOL,
+
+    /*!
+     *  Received bytes fill the application's streamBufs back to back,
+     *  regardless of transaction boundaries. Each full buffer is handed out
+     *  by I2CSlave_readBlock() and must be given back, in order, with
+     *  I2CSlave_releaseBlock(). A buffer is only handed out once it is
+     *  full: bytes in a partly filled buffer wait for the master to send
+     *  the rest, however long that takes.
+     */
+    I2CSLAVE_MODE_STREAM,
+
+    /*!
+     *  Every master write holds packets that start with a length field, see
+     *  packetLenOffset and packetLenSize. I2CSlave_read() returns one whole
+     *  packet, and only once it has been completely received.
+     */
+    I2CSLAVE_MODE_PACKET
+} I2CSlave_ReadMode;
 
 typedef struct I2CSlave_Params {
+    I2CSlave_ReadMode readMode;         /*!< Mode for all read calls */
     unsigned int      readTimeout;      /*!< Timeout for read semaphore */
     unsigned int      writeTimeout;     /*!< Timeout for write semaphore */
+    unsigned int      writePendingTimeout; /*!< Timeout before a 0x00 is sent */
     unsigned char     slaveAddress;     /*!< Slave address */
+    bool              frameTimestamps;  /*!< Timestamp each master write */
+    const I2CSlave_Cmd *cmdTable;       /*!< Commands answered in the ISR */
+    size_t            cmdCount;         /*!< Number of entries in cmdTable */
+    bool              txPrestage;       /*!< Queue the reply in the TX FIFO */
+    bool              rxBackpressure;   /*!< Hold SCL instead of dropping */
+    void * const     *streamBufs;       /*!< Buffers of I2CSLAVE_MODE_STREAM */
+    size_t            streamBufCount;   /*!< Number of streamBufs, at least 2 */
+    size_t            streamBufSize;    /*!< Size of each of the streamBufs */
+    size_t            packetLenOffset;  /*!< Offset of the length field */
+    size_t            packetLenSize;    /*!< Length field bytes, 1 or 2, MSB first */
+    size_t            packetMaxSize;    /*!< Largest packet, 0 for the ring size */
+    /*!
+     *  Percentile of the application's response time the write pending
+     *  timeout adapts to, 0 to keep writePendingTimeout fixed. The adapted
+     *  timeout starts at writePendingTimeout and stays within
+     *  writePendingMin and writePendingMax.
+     */
+    unsigned int      writePendingPercentile;
+    unsigned int      writePendingMin;  /*!< Shortest adapted timeout */
+    unsigned int      writePendingMax;  /*!< Longest adapted timeout */
+    unsigned int      busWatchdog;      /*!< Ticks before a stuck bus is reset, 0 for none */
+    /*!
+     *  Ticks a reply given to I2CSlave_write() is remembered for the master
+     *  write it answered, 0 for no reply cache. The same master write within
+     *  that time is answered from the cache without the task.
+     */
+    unsigned int      replyCacheLifetime;
+    bool              generalCall;      /*!< Acknowledge general call frames */
+    /*!
+     *  Hand the general call frames received by any instance to
+     *  I2CSlave_readBroadcast() of this one.
+     */
+    bool              generalCallSubscribe;
+    const I2CSlave_Sink *sinks;         /*!< Stages received bytes go through */
+    size_t            sinkCount;        /*!< Number of entries in sinks */
+    /*!
+     *  The master may switch the bus to High-speed mode (3.4 Mbit/s).
+     *  Received bytes are taken from the receive FIFO in bursts.
+     */
+    bool              highSpeed;
 } I2CSlave_Params;
 
 typedef void            (*I2CSlave_CloseFxn)          (I2CSlave_Handle handle);
@@ -42,6 +160,22 @@ typedef int             (*I2CSlave_ReadFxn)           (I2CSlave_Handle handle, v
 typedef int             (*I2CSlave_WriteFxn)          (I2CSlave_Handle handle,
                                                        const void *buffer,
                                                        size_t size);
+typedef int             (*I2CSlave_ReadBlockFxn)      (I2CSlave_Handle handle,
+                                                       void **block);
+typedef void            (*I2CSlave_ReleaseBlockFxn)   (I2CSlave_Handle handle,
+                                                       void *block);
+typedef int             (*I2CSlave_ReadTimestampFxn)  (I2CSlave_Handle handle,
+                                                       void *buffer,
+                                                       size_t size,
+                                                       uint32_t *timestamp);
+typedef int             (*I2CSlave_TransactFxn)       (I2CSlave_Handle handle,
+                                                       void *rxBuf,
+                                                       size_t rxLen,
+                                                       I2CSlave_CmdFxn responder);
+typedef int             (*I2CSlave_ReadBroadcastFxn)  (I2CSlave_Handle handle,
+                                                       void **frame);
+typedef void            (*I2CSlave_ReleaseBroadcastFxn) (I2CSlave_Handle handle,
+                                                       void *frame);
 
 typedef struct I2CSlave_FxnTable {
     /*! Function to close the specified peripheral */
@@ -58,6 +192,24 @@ typedef struct I2CSlave_FxnTable {
 
     /*! Function to write from the specified peripheral */
     I2CSlave_WriteFxn       writeFxn;
+
+    /*! Function to get the next received block */
+    I2CSlave_ReadBlockFxn   readBlockFxn;
+
+    /*! Function to give a received block back to the driver */
+    I2CSlave_ReleaseBlockFxn releaseBlockFxn;
+
+    /*! Function to read and return the arrival time of the data */
+    I2CSlave_ReadTimestampFxn readTimestampFxn;
+
+    /*! Function to receive a command and send the reply in one call */
+    I2CSlave_TransactFxn    transactFxn;
+
+    /*! Function to get the next general call frame */
+    I2CSlave_ReadBroadcastFxn readBroadcastFxn;
+
+    /*! Function to give a general call frame back to the driver */
+    I2CSlave_ReleaseBroadcastFxn releaseBroadcastFxn;
 } I2CSlave_FxnTable;
 
 typedef struct I2CSlave_Config {
@@ -81,4 +233,39 @@ extern int I2CSlave_write(I2CSlave_Handle handle, const void *buffer, size_t siz
 
 extern int I2CSlave_read(I2CSlave_Handle handle, void *buffer, size_t size);
 
+/*
+ *  Same as I2CSlave_read(). timestamp receives the time at which the master
+ *  write holding the first returned byte started, when the instance was
+ *  opened with frameTimestamps, or 0 if the driver had no room to keep it.
+ */
+extern int I2CSlave_readTimestamp(I2CSlave_Handle handle, void *buffer,
+                                  size_t size, uint32_t *timestamp);
+
+extern int I2CSlave_readBlock(I2CSlave_Handle handle, void **block);
+
+extern void I2CSlave_releaseBlock(I2CSlave_Handle handle, void *block);
+
+/*
+ *  Receives rxLen bytes from the master into rxBuf, then responder builds
+ *  the reply from the ISR and it is sent on the following master read, all
+ *  in one call. Returns the number of reply bytes the master read within
+ *  readTimeout + writeTimeout, which is fewer than the reply if the master
+ *  ended its read early or did not read in time. Returns I2CSLAVE_ERROR if
+ *  the command was not complete in that time, if a write or transact is
+ *  already in progress, or if rxLen is 0 or responder is NULL.
+ */
+extern int I2CSlave_transact(I2CSlave_Handle handle, void *rxBuf, size_t rxLen,
+                             I2CSlave_CmdFxn responder);
+
+/*
+ *  Returns the size of the next general call frame and points frame at it,
+ *  or I2CSLAVE_ERROR if none arrived within readTimeout. The frame is shared
+ *  with the other subscribed instances and must not be modified. It must be
+ *  given back with I2CSlave_releaseBroadcast(), in the order the frames
+ *  were read.
+ */
+extern int I2CSlave_readBroadcast(I2CSlave_Handle handle, void **frame);
+
+extern void I2CSlave_releaseBroadcast(I2CSlave_Handle handle, void *frame);
+
 #endif /* I2CSLAVE_H_ */
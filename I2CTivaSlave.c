@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <xdc/runtime/Error.h>
 #include <xdc/runtime/Assert.h>
 #include <xdc/runtime/Diags.h>
@@ -31,6 +32,35 @@
 #include <driverlib/sysctl.h>
 #endif
 
+/* Driver events are traced with Log_print1(), see I2CTIVASLAVE_USE_LOG */
+#if !I2CTIVASLAVE_USE_LOG
+#undef Log_print1
+#define Log_print1(mask, format, arg)   ((void)0)
+#endif
+
+/* Read and write completion, see I2CTIVASLAVE_USE_CALLBACKS */
+#if I2CTIVASLAVE_USE_CALLBACKS
+#define READ_CALLBACK(object)   ((object)->readCallback)
+#define WRITE_CALLBACK(object)  ((object)->writeCallback)
+#else
+#define READ_CALLBACK(object)   readSemCallback
+#define WRITE_CALLBACK(object)  writeSemCallback
+#endif
+
+/* Counters of I2CTivaSlave_getStats(), see I2CTIVASLAVE_USE_STATS */
+#if I2CTIVASLAVE_USE_STATS
+#define STATS_ADD(object, field, n)     ((object)->stats.field += (n))
+#else
+#define STATS_ADD(object, field, n)     ((void)(n))
+#endif
+
+/* Cortex-M debug registers for the DWT cycle counter */
+#define DEMCR                   0xE000EDFC
+#define DEMCR_TRCENA            0x01000000
+#define DWT_CTRL                0xE0001000
+#define DWT_CTRL_CYCCNTENA      0x00000001
+#define DWT_CYCCNT              0xE0001004
+
 /* I2CTivaSlave functions */
 void            I2CTivaSlave_close(I2CSlave_Handle handle);
 void            I2CTivaSlave_init(I2CSlave_Handle handle);
@@ -38,13 +68,112 @@ I2CSlave_Handle I2CTivaSlave_open(I2CSlave_Handle handle, I2CSlave_Params *param
 int             I2CTivaSlave_read(I2CSlave_Handle handle, void *buffer, size_t size);
 int             I2CTivaSlave_write(I2CSlave_Handle handle, const void *buffer,
                                    size_t size);
+int             I2CTivaSlave_readTimestamp(I2CSlave_Handle handle, void *buffer,
+                                           size_t size, uint32_t *timestamp);
+int             I2CTivaSlave_readBlock(I2CSlave_Handle handle, void **block);
+void            I2CTivaSlave_releaseBlock(I2CSlave_Handle handle, void *block);
+int             I2CTivaSlave_transact(I2CSlave_Handle handle, void *rxBuf,
+                                      size_t rxLen, I2CSlave_CmdFxn responder);
+int             I2CTivaSlave_readBroadcast(I2CSlave_Handle handle, void **frame);
+void            I2CTivaSlave_releaseBroadcast(I2CSlave_Handle handle,
+                                              void *frame);
 
 /* Static functions */
+#if I2CTIVASLAVE_USE_CMD_TABLE
+static bool dispatchCmd(I2CSlave_Handle handle, uint32_t i2cstatus,
+                        unsigned char data);
+static void runCmd(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+static void dropIsrReply(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
 static void readBlockingTimeout(UArg arg);
+#endif
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
 static Void writePendingTimeoutCallback(UArg arg);
-static bool readIsrBinaryBlocking(I2CSlave_Handle handle);
+#endif
+static bool readIsrBinaryBlocking(I2CSlave_Handle handle, unsigned char data);
+#if I2CTIVASLAVE_USE_POOL
+static bool readIsrPool(I2CSlave_Handle handle, unsigned char data);
+static void endIsrPool(I2CSlave_Handle handle);
+static int  readBlockPool(I2CSlave_Handle handle, void **block);
+static void releaseBlockPool(I2CSlave_Handle handle, void *block);
+static I2CTivaSlave_PoolBlock *poolBlockOf(I2CSlave_Handle handle, void *block);
+static int  readTaskPool(I2CSlave_Handle handle);
+#endif
+static void deliverData(I2CSlave_Handle handle, unsigned char data);
+static void endReadFrame(I2CSlave_Handle handle);
+static void endWrite(I2CSlave_Handle handle);
 static void readSemCallback(I2CSlave_Handle handle, void *buffer, size_t count);
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+static void receiveBurst(I2CSlave_Handle handle);
+#endif
+static void receiveByte(I2CSlave_Handle handle, uint32_t i2cstatus,
+                        unsigned char data);
+static void receiveData(I2CSlave_Handle handle, uint32_t i2cstatus);
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+static void releaseHeld(I2CSlave_Handle handle);
+#endif
 static int  readTaskBlocking(I2CSlave_Handle handle);
+#if I2CTIVASLAVE_USE_STREAM
+static bool readIsrStream(I2CSlave_Handle handle, unsigned char data);
+static int  readBlockStream(I2CSlave_Handle handle, void **block);
+static void releaseBlockStream(I2CSlave_Handle handle, void *block);
+static int  readTaskStream(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_PACKET
+static bool readIsrPacket(I2CSlave_Handle handle, unsigned char data);
+static void endIsrPacket(I2CSlave_Handle handle);
+static int  readTaskPacket(I2CSlave_Handle handle);
+#endif
+static bool putRing(I2CSlave_Handle handle, unsigned char data);
+#if I2CTIVASLAVE_USE_TRANSACT
+static void runTransact(I2CSlave_Handle handle);
+static bool transactIsr(I2CSlave_Handle handle, unsigned char data);
+#endif
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+static void adaptPendTimeout(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+static void bcastEndFrame(I2CSlave_Handle handle);
+static I2CTivaSlave_BcastFrame *bcastFrameOf(I2CTivaSlave_Broadcast *broadcast,
+                                             uint32_t seq);
+static void bcastFree(I2CTivaSlave_Broadcast *broadcast);
+static void bcastReceive(I2CSlave_Handle handle, uint32_t i2cstatus);
+static void bcastUnsubscribe(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_WATCHDOG
+static Void busWatchdogCallback(UArg arg);
+static void recoverBus(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+static void cacheEndFrame(I2CSlave_Handle handle);
+static I2CTivaSlave_CacheEntry *cacheFind(I2CSlave_Handle handle,
+                                          size_t size, bool prefix);
+static void cacheFlush(I2CSlave_Handle handle);
+static bool cacheReceive(I2CSlave_Handle handle, unsigned char data);
+static void cacheStore(I2CSlave_Handle handle, const void *reply, size_t size);
+#endif
+static void initHw(I2CSlave_Handle handle);
+static void resumeWrite(I2CSlave_Handle handle);
+#if I2CTIVASLAVE_USE_PRESTAGE
+static void stageData(I2CSlave_Handle handle);
+static void takeStaged(I2CSlave_Handle handle);
+static void unstageData(I2CSlave_Handle handle);
+#endif
+#if I2CTIVASLAVE_USE_SINKS
+static void sinkDeliver(I2CSlave_Handle handle, I2CTivaSlave_SinkBatch *batch);
+static void sinkFlush(I2CSlave_Handle handle, bool end);
+static void sinkReceive(I2CSlave_Handle handle, unsigned char data);
+static void sinkRun(I2CSlave_Handle handle, size_t first, size_t last,
+                    I2CTivaSlave_SinkBatch *batch);
+static Void sinkSwiFxn(UArg arg0, UArg arg1);
+#endif
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+static uint32_t timestampCycCnt(void);
+static void updateReadStamp(I2CSlave_Handle handle, uint32_t startSeq);
+#endif
 static void writeData(I2CSlave_Handle handle);
 static void writeSemCallback(I2CSlave_Handle handle, void *buffer, size_t count);
 
@@ -55,15 +184,53 @@ const I2CSlave_FxnTable I2CTivaSlave_fxnTable = {
     I2CTivaSlave_open,
     I2CTivaSlave_read,
     I2CTivaSlave_write,
+    I2CTivaSlave_readBlock,
+    I2CTivaSlave_releaseBlock,
+    I2CTivaSlave_readTimestamp,
+    I2CTivaSlave_transact,
+    I2CTivaSlave_readBroadcast,
+    I2CTivaSlave_releaseBroadcast,
 };
 
 /*
  *  ======== staticFxnTable ========
  *  This is a function lookup table to simplify the I2CSlave driver modes.
  */
-static const I2CTivaSlave_FxnSet staticFxnTable = {
-    .readIsrFxn  = readIsrBinaryBlocking,
-    .readTaskFxn = readTaskBlocking
+static const I2CTivaSlave_FxnSet staticFxnTable[] = {
+    {/* I2CSLAVE_MODE_BLOCKING */
+        .readIsrFxn      = readIsrBinaryBlocking,
+        .readTaskFxn     = readTaskBlocking,
+        .endIsrFxn       = NULL,
+        .readBlockFxn    = NULL,
+        .releaseBlockFxn = NULL
+    },
+    {/* I2CSLAVE_MODE_POOL */
+#if I2CTIVASLAVE_USE_POOL
+        .readIsrFxn      = readIsrPool,
+        .readTaskFxn     = readTaskPool,
+        .endIsrFxn       = endIsrPool,
+        .readBlockFxn    = readBlockPool,
+        .releaseBlockFxn = releaseBlockPool
+#endif
+    },
+    {/* I2CSLAVE_MODE_STREAM */
+#if I2CTIVASLAVE_USE_STREAM
+        .readIsrFxn      = readIsrStream,
+        .readTaskFxn     = readTaskStream,
+        .endIsrFxn       = NULL,
+        .readBlockFxn    = readBlockStream,
+        .releaseBlockFxn = releaseBlockStream
+#endif
+    },
+    {/* I2CSLAVE_MODE_PACKET */
+#if I2CTIVASLAVE_USE_PACKET
+        .readIsrFxn      = readIsrPacket,
+        .readTaskFxn     = readTaskPacket,
+        .endIsrFxn       = endIsrPacket,
+        .readBlockFxn    = NULL,
+        .releaseBlockFxn = NULL
+#endif
+    }
 };
 
 /*
@@ -80,11 +247,45 @@ void I2CTivaSlave_close(I2CSlave_Handle handle)
 
     Hwi_destruct(&(object->hwi));
 
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /* Hand out what was received of a general call, then leave the list */
+    if (object->bcastFill != NULL) {
+        bcastEndFrame(handle);
+    }
+    if (object->state.bcastSubscribed) {
+        bcastUnsubscribe(handle);
+        Semaphore_destruct(&object->bcastSem);
+    }
+#endif
+
     Semaphore_destruct(&object->writeSem);
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
     Clock_destruct(&object->writeTimeoutClk);
+#endif
 
     Semaphore_destruct(&object->readSem);
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
     Clock_destruct(&object->timeoutClk);
+#endif
+
+#if I2CTIVASLAVE_USE_WATCHDOG
+    if (object->busWatchdog) {
+        Clock_destruct(&object->watchdogClk);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_POOL
+    if (object->readMode == I2CSLAVE_MODE_POOL) {
+        Queue_destruct(&object->poolFree);
+        Queue_destruct(&object->poolReady);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_SINKS
+    if (object->sinkIsrCount < object->sinkCount) {
+        Swi_destruct(&object->sinkSwi);
+    }
+#endif
 
     object->state.opened = false;
 }
@@ -96,6 +297,10 @@ static void I2CTivaSlave_hwiIntFxn(UArg arg)
 {
     uint32_t                     status;
     uint32_t                     i2cstatus;
+    bool                         endFrame;
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    bool                         bcastEnd;
+#endif
     I2CTivaSlave_Object         *object = ((I2CSlave_Handle)arg)->object;
     I2CTivaSlave_HWAttrs const  *hwAttrs = ((I2CSlave_Handle)arg)->hwAttrs;
 
@@ -104,9 +309,116 @@ static void I2CTivaSlave_hwiIntFxn(UArg arg)
     status = I2CSlaveIntStatusEx(hwAttrs->baseAddr, true);
     I2CSlaveIntClearEx(hwAttrs->baseAddr, status);
 
+#if I2CTIVASLAVE_USE_WATCHDOG
+    if (object->busWatchdog) {
+        object->activityTick = Clock_getTicks();
+        object->state.busReset = false;
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+    /* Bytes in the receive FIFO came before the START or STOP, if any */
+    if (object->state.highSpeed) {
+        receiveBurst((I2CSlave_Handle)arg);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /* The master may have taken the staged byte, and then ended its read */
+    if (object->state.txStaged &&
+        (status & (I2C_SLAVE_INT_TX_FIFO_REQ | I2C_SLAVE_INT_START |
+                   I2C_SLAVE_INT_STOP))) {
+        takeStaged((I2CSlave_Handle)arg);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    /* Before anything else, a master write that was a retry is answered */
+    if ((status & (I2C_SLAVE_INT_START | I2C_SLAVE_INT_STOP)) &&
+        object->cacheLifetime) {
+        cacheEndFrame((I2CSlave_Handle)arg);
+    }
+#endif
+
+    /*
+     * A START or STOP reported together with the first byte of a transaction
+     * ended the previous frame; otherwise the byte still belongs to the frame
+     * being closed.
+     */
+    endFrame = (status & (I2C_SLAVE_INT_START | I2C_SLAVE_INT_STOP)) != 0;
+    if (endFrame && (i2cstatus & I2C_SCSR_FBR)) {
+        endReadFrame((I2CSlave_Handle)arg);
+        endFrame = false;
+    }
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /* The same goes for a general call frame */
+    bcastEnd = (status & (I2C_SLAVE_INT_START | I2C_SLAVE_INT_STOP)) &&
+        object->bcastFill != NULL;
+    if (bcastEnd && (i2cstatus & I2C_SCSR_FBR)) {
+        bcastEndFrame((I2CSlave_Handle)arg);
+        bcastEnd = false;
+    }
+#endif
+
+    if (status & (I2C_SLAVE_INT_START | I2C_SLAVE_INT_STOP)) {
+        /* A START or STOP ends the master read in progress */
+        if (object->state.txActive) {
+            endWrite((I2CSlave_Handle)arg);
+        }
+
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+        /* The application's response time is measured from here */
+        if (object->pendPercentile && object->state.rxFrame) {
+            object->cmdEndTick = Clock_getTicks();
+            object->state.pendSample = true;
+        }
+#endif
+
+        object->state.frameOpen = (status & I2C_SLAVE_INT_START) != 0;
+        object->state.rxFrame = false;
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+        object->state.rxFirst = object->state.frameOpen;
+#endif
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+        /* Queue the reply before the master asks for it */
+        if ((status & I2C_SLAVE_INT_START) && !object->state.txActive) {
+            stageData((I2CSlave_Handle)arg);
+        }
+#endif
+    }
+
     if (i2cstatus & I2C_SLAVE_ACT_RREQ) {
         if (status & I2C_SLAVE_INT_DATA) {
-            object->readFxns.readIsrFxn((I2CSlave_Handle)arg);
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+            if (object->state.generalCall &&
+                (i2cstatus & I2C_SLAVE_ACT_OWN2SEL)) {
+                bcastReceive((I2CSlave_Handle)arg, i2cstatus);
+            }
+            else
+#endif
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+            if (object->rxBackpressure &&
+#if I2CTIVASLAVE_USE_TRANSACT
+                object->xactBuf == NULL &&
+#endif
+                RingBuf_isFull(&object->ringBuffer)) {
+                /*
+                 * Leave the byte in the data register, which holds SCL, until
+                 * the task has made room in the ring.
+                 */
+                Log_print1(Diags_USER1, "SLV: hold rx %d", 1);
+                I2CSlaveIntDisableEx(hwAttrs->baseAddr, I2C_SLAVE_INT_DATA);
+                object->heldStatus = i2cstatus;
+                object->state.rxHeld = true;
+                STATS_ADD(object, rxHolds, 1);
+            }
+            else
+#endif
+            {
+                receiveData((I2CSlave_Handle)arg, i2cstatus);
+            }
         }
     }
 
@@ -114,6 +426,34 @@ static void I2CTivaSlave_hwiIntFxn(UArg arg)
         Log_print1(Diags_USER1, "SLV: write in isr %d", 1);
         writeData((I2CSlave_Handle)arg);
     }
+
+    if (endFrame) {
+        endReadFrame((I2CSlave_Handle)arg);
+    }
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    if (bcastEnd) {
+        bcastEndFrame((I2CSlave_Handle)arg);
+    }
+#endif
+}
+
+/*
+ *  ======== I2CTivaSlave_getStats ========
+ */
+void I2CTivaSlave_getStats(I2CSlave_Handle handle, I2CTivaSlave_Stats *stats)
+{
+#if I2CTIVASLAVE_USE_STATS
+    unsigned int                key;
+    I2CTivaSlave_Object        *object = handle->object;
+
+    key = Hwi_disable();
+    *stats = object->stats;
+    Hwi_restore(key);
+#else
+    (void)handle;
+    memset(stats, 0, sizeof(*stats));
+#endif
 }
 
 /*
@@ -132,14 +472,134 @@ void I2CTivaSlave_init(I2CSlave_Handle handle)
 I2CSlave_Handle I2CTivaSlave_open(I2CSlave_Handle handle, I2CSlave_Params *params)
 {
     unsigned int               key;
+    size_t                     i;
     I2CTivaSlave_Object           *object = handle->object;
     I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
     union {
         Hwi_Params             hwiParams;
         Semaphore_Params       semParams;
         Clock_Params           clockParams;
+#if I2CTIVASLAVE_USE_SINKS
+        Swi_Params             swiParams;
+#endif
     } paramsUnion;
 
+    /* readMode indexes staticFxnTable */
+    if ((unsigned int)params->readMode >=
+        sizeof(staticFxnTable) / sizeof(staticFxnTable[0])) {
+        return (NULL);
+    }
+
+    /* Features left out by I2CTivaSlaveConfig.h */
+    if ((!I2CTIVASLAVE_USE_POOL && params->readMode == I2CSLAVE_MODE_POOL) ||
+        (!I2CTIVASLAVE_USE_STREAM &&
+         params->readMode == I2CSLAVE_MODE_STREAM) ||
+        (!I2CTIVASLAVE_USE_PACKET &&
+         params->readMode == I2CSLAVE_MODE_PACKET) ||
+        (!I2CTIVASLAVE_USE_TIMESTAMPS && params->frameTimestamps) ||
+        (!I2CTIVASLAVE_USE_CMD_TABLE && params->cmdCount) ||
+        (!I2CTIVASLAVE_USE_PRESTAGE && params->txPrestage) ||
+        (!I2CTIVASLAVE_USE_BACKPRESSURE && params->rxBackpressure) ||
+        (!I2CTIVASLAVE_USE_READ_TIMEOUT &&
+         params->readMode == I2CSLAVE_MODE_BLOCKING &&
+         params->readTimeout != 0 &&
+         params->readTimeout != (unsigned int)I2CSLAVE_WAIT_FOREVER) ||
+        (!I2CTIVASLAVE_USE_ADAPTIVE_PEND && params->writePendingPercentile) ||
+        (!I2CTIVASLAVE_USE_WATCHDOG && params->busWatchdog) ||
+        (!I2CTIVASLAVE_USE_REPLY_CACHE && params->replyCacheLifetime) ||
+        (!I2CTIVASLAVE_USE_GENERAL_CALL &&
+         (params->generalCall || params->generalCallSubscribe)) ||
+        (!I2CTIVASLAVE_USE_SINKS && params->sinkCount) ||
+        (!I2CTIVASLAVE_USE_HIGH_SPEED && params->highSpeed)) {
+        return (NULL);
+    }
+
+    /* Every command must fit in the opcode + argument buffer */
+    for (i = 0; i < params->cmdCount; i++) {
+        if (params->cmdTable[i].argSize + 1 > I2CTIVASLAVE_CMD_SIZE ||
+            params->cmdTable[i].cmdFxn == NULL) {
+            return (NULL);
+        }
+    }
+
+    /*
+     * Sink stages run in order, ISR stages first. Bytes in a batch have been
+     * acknowledged, so cannot be held back or refused by the packet mode,
+     * and a Swi stage would deliver a frame after its timestamp has been
+     * overwritten.
+     */
+    for (i = 0; i < params->sinkCount; i++) {
+        if (params->sinks[i].sinkFxn == NULL ||
+            (i > 0 && params->sinks[i].level < params->sinks[i - 1].level) ||
+            params->rxBackpressure ||
+            params->readMode == I2CSLAVE_MODE_PACKET ||
+            (params->frameTimestamps &&
+             params->sinks[i].level == I2CSLAVE_SINK_SWI)) {
+            return (NULL);
+        }
+    }
+
+    /*
+     * The receive FIFO acknowledges every byte and does not tell the own
+     * addresses apart, so nothing that acts on a single byte can be used in
+     * High-speed mode. Nor does it mark the first byte of a master write:
+     * when the ISR is late the bytes of two writes are taken in one burst,
+     * so nothing that parses a write as a unit can be used either. 0000 1xx
+     * is the master code that switches the bus to High-speed mode, which no
+     * slave may answer.
+     */
+    if (params->highSpeed &&
+        (params->rxBackpressure || params->generalCall ||
+         params->readMode == I2CSLAVE_MODE_PACKET ||
+         params->cmdCount || params->replyCacheLifetime ||
+         (params->slaveAddress & 0x7C) == 0x04)) {
+        return (NULL);
+    }
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    /* The reply cache needs its entries from the board file */
+    if (params->replyCacheLifetime &&
+        (hwAttrs->replyCache == NULL || hwAttrs->replyCacheCount == 0)) {
+        return (NULL);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /* General calls are kept in frames shared by all ports */
+    if ((params->generalCall || params->generalCallSubscribe) &&
+        hwAttrs->broadcast == NULL) {
+        return (NULL);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_POOL
+    /* The pool mode needs storage from the board file */
+    if (params->readMode == I2CSLAVE_MODE_POOL &&
+        (hwAttrs->poolBlocks == NULL || hwAttrs->poolBufPtr == NULL ||
+         hwAttrs->poolBlockCount == 0 || hwAttrs->poolBlockSize == 0)) {
+        return (NULL);
+    }
+#endif
+
+    /* The stream mode needs at least two buffers from the application */
+    if (params->readMode == I2CSLAVE_MODE_STREAM &&
+        (params->streamBufs == NULL || params->streamBufCount < 2 ||
+         params->streamBufSize == 0)) {
+        return (NULL);
+    }
+
+    /*
+     * The packet mode needs a length field within the header buffer, and a
+     * packet must fit in the ring buffer.
+     */
+    if (params->readMode == I2CSLAVE_MODE_PACKET &&
+        (params->packetLenSize < 1 || params->packetLenSize > 2 ||
+         params->packetLenOffset + params->packetLenSize >
+             I2CTIVASLAVE_PACKET_HEADER ||
+         params->packetMaxSize > hwAttrs->ringBufSize)) {
+        return (NULL);
+    }
+
     key = Hwi_disable();
 
     if (object->state.opened == true) {
@@ -152,9 +612,93 @@ I2CSlave_Handle I2CTivaSlave_open(I2CSlave_Handle handle, I2CSlave_Params *param
 
     object->readTimeout          = params->readTimeout;
     object->writeTimeout         = params->writeTimeout;
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
     object->writePendTimeout     = params->writePendingTimeout;
+#endif
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+    object->pendPercentile       = params->writePendingPercentile < 100 ?
+        params->writePendingPercentile : 99;
+    object->pendMin              = params->writePendingMin;
+    object->pendMax              = params->writePendingMax;
+    object->pendEstimate         = params->writePendingTimeout << 4;
+    object->state.pendSample     = false;
+    object->state.pendSeeded     = false;
+#endif
+#if I2CTIVASLAVE_USE_WATCHDOG
+    object->busWatchdog          = params->busWatchdog;
+    object->state.busReset       = false;
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    object->cacheLifetime        = params->replyCacheLifetime;
+    object->keySize              = 0;
+    object->lastCmdSize          = 0;
+    object->cmdPending           = 0;
+    for (i = 0; object->cacheLifetime && i < hwAttrs->replyCacheCount; i++) {
+        hwAttrs->replyCache[i].cmdSize = 0;
+    }
+    object->state.keyHold        = true;
+#endif
     object->slaveAddress         = params->slaveAddress;
-    object->readFxns             = staticFxnTable;
+    object->readMode             = params->readMode;
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+    object->rxBackpressure       = params->rxBackpressure &&
+        params->readMode == I2CSLAVE_MODE_BLOCKING;
+#endif
+    object->readFxns             = &staticFxnTable[params->readMode];
+#if I2CTIVASLAVE_USE_PRESTAGE
+    object->txPrestage           = params->txPrestage;
+#endif
+#if I2CTIVASLAVE_USE_CMD_TABLE
+    object->cmdTable             = params->cmdTable;
+    object->cmdCount             = params->cmdCount;
+    object->cmd                  = NULL;
+    object->cmdSize              = 0;
+#endif
+#if I2CTIVASLAVE_USE_TRANSACT
+    object->xactBuf              = NULL;
+#endif
+    object->state.writeActive    = false;
+    object->state.txActive       = false;
+#if I2CTIVASLAVE_USE_PRESTAGE
+    object->state.txStaged       = false;
+#endif
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+    object->state.isrReply       = false;
+#endif
+#if !I2CTIVASLAVE_USE_PEND_TIMEOUT
+    object->state.txPending      = false;
+#endif
+    object->state.frameOpen      = false;
+    object->state.rxFrame        = false;
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+    object->state.rxHeld         = false;
+#endif
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    object->state.generalCall    = params->generalCall;
+    object->state.bcastSubscribed = false;
+    object->bcastFill            = NULL;
+#endif
+#if I2CTIVASLAVE_USE_SINKS
+    object->sinks                = params->sinks;
+    object->sinkCount            = params->sinkCount;
+    for (object->sinkIsrCount = 0;
+         object->sinkIsrCount < object->sinkCount &&
+         object->sinks[object->sinkIsrCount].level == I2CSLAVE_SINK_ISR;
+         object->sinkIsrCount++) {
+    }
+    object->sinkHead             = 0;
+    object->sinkReady            = 0;
+    for (i = 0; i <= I2CTIVASLAVE_SINK_DEPTH; i++) {
+        object->sinkBatches[i].count = 0;
+        object->sinkBatches[i].end = false;
+    }
+    object->state.sinkFrame      = false;
+#endif
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+    object->state.highSpeed      = params->highSpeed;
+    object->state.rxFirst        = false;
+#endif
 
     /* Set I2CSlave variables to defaults. */
     object->writeBuf             = NULL;
@@ -163,9 +707,78 @@ I2CSlave_Handle I2CTivaSlave_open(I2CSlave_Handle handle, I2CSlave_Params *param
     object->readCount            = 0;
     object->writeSize            = 0;
     object->readSize             = 0;
+#if I2CTIVASLAVE_USE_STATS
+    memset(&object->stats, 0, sizeof(object->stats));
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
+    object->stats.txPendTimeout  = object->writePendTimeout;
+#endif
+#endif
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    object->timestampFxn         = NULL;
+    object->stampHead            = 0;
+    object->stampCount           = 0;
+    object->rxSeq                = 0;
+    object->readSeq              = 0;
+    object->readStamp            = 0;
+    object->state.stampPending   = false;
+    object->state.stampLost      = false;
+    /* Stream buffers do not follow master writes, so are not timestamped */
+    if (params->frameTimestamps &&
+        params->readMode != I2CSLAVE_MODE_STREAM) {
+        if (hwAttrs->timestampFxn != NULL) {
+            object->timestampFxn = hwAttrs->timestampFxn;
+        }
+        else {
+            HWREG(DEMCR) |= DEMCR_TRCENA;
+            HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+            object->timestampFxn = timestampCycCnt;
+        }
+    }
+#endif
 
     RingBuf_construct(&object->ringBuffer, hwAttrs->ringBufPtr,
         hwAttrs->ringBufSize);
+
+#if I2CTIVASLAVE_USE_POOL
+    if (object->readMode == I2CSLAVE_MODE_POOL) {
+        Queue_construct(&object->poolFree, NULL);
+        Queue_construct(&object->poolReady, NULL);
+        for (i = 0; i < hwAttrs->poolBlockCount; i++) {
+            hwAttrs->poolBlocks[i].data = hwAttrs->poolBufPtr +
+                i * hwAttrs->poolBlockSize;
+            hwAttrs->poolBlocks[i].count = 0;
+            hwAttrs->poolBlocks[i].inUse = false;
+            Queue_enqueue(Queue_handle(&object->poolFree),
+                &hwAttrs->poolBlocks[i].elem);
+        }
+        object->poolFill = NULL;
+        object->state.poolDrop = false;
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_STREAM
+    object->streamBufs           = params->streamBufs;
+    object->streamBufCount       = params->streamBufCount;
+    object->streamBufSize        = params->streamBufSize;
+    object->streamHead           = 0;
+    object->streamTaken          = 0;
+    object->streamReady          = 0;
+    object->streamPos            = 0;
+#endif
+
+#if I2CTIVASLAVE_USE_PACKET
+    object->pktLenOffset         = params->packetLenOffset;
+    object->pktLenSize           = params->packetLenSize;
+    object->pktMaxSize           = params->packetMaxSize ?
+        params->packetMaxSize : hwAttrs->ringBufSize;
+    object->pktPos               = 0;
+    object->packetHead           = 0;
+    object->packetCount          = 0;
+    object->state.pktDrop        = false;
+    object->state.pktReject      = false;
+#endif
+
     Hwi_Params_init(&paramsUnion.hwiParams);
     paramsUnion.hwiParams.arg = (UArg)handle;
     paramsUnion.hwiParams.priority = hwAttrs->intPriority;
@@ -177,35 +790,74 @@ I2CSlave_Handle I2CTivaSlave_open(I2CSlave_Handle handle, I2CSlave_Params *param
 
     /* If write mode is blocking create a semaphore and set callback. */
     Semaphore_construct(&object->writeSem, 0, &paramsUnion.semParams);
+#if I2CTIVASLAVE_USE_CALLBACKS
     object->writeCallback = &writeSemCallback;
+#endif
 
     /* If read mode is blocking create a semaphore and set callback. */
     Semaphore_construct(&object->readSem, 0, &(paramsUnion.semParams));
+#if I2CTIVASLAVE_USE_CALLBACKS
     object->readCallback = &readSemCallback;
+#endif
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /* Only frames that start from now on are handed to this instance */
+    if (params->generalCallSubscribe) {
+        Semaphore_construct(&object->bcastSem, 0, &paramsUnion.semParams);
+
+        key = Hwi_disable();
+        object->bcastRead = hwAttrs->broadcast->seq;
+        object->bcastRelease = hwAttrs->broadcast->seq;
+        object->bcastNext = hwAttrs->broadcast->subscribers;
+        hwAttrs->broadcast->subscribers = object;
+        hwAttrs->broadcast->subscriberCount++;
+        object->state.bcastSubscribed = true;
+        Hwi_restore(key);
+    }
+#endif
     Clock_Params_init(&paramsUnion.clockParams);
     paramsUnion.clockParams.period = 0;
     paramsUnion.clockParams.startFlag = FALSE;
     paramsUnion.clockParams.arg = (UArg)handle;
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
     Clock_construct(&object->timeoutClk,
                     readBlockingTimeout,
                     object->readTimeout,
                     &paramsUnion.clockParams);
+#endif
 
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
     /* Clock for pending writes */
     Clock_construct(&object->writeTimeoutClk,
                     writePendingTimeoutCallback,
                     object->writePendTimeout,
                     &paramsUnion.clockParams);
+#endif
 
-    I2CSlaveInit(hwAttrs->baseAddr, params->slaveAddress);
-
-    /* Enable I2CSlave and its interrupt. */
-    I2CSlaveIntClearEx(hwAttrs->baseAddr, I2C_SLAVE_INT_DATA);
+#if I2CTIVASLAVE_USE_WATCHDOG
+    /* Periodic check for a bus left stuck by the master */
+    if (object->busWatchdog) {
+        object->activityTick = Clock_getTicks();
+        paramsUnion.clockParams.period = object->busWatchdog;
+        paramsUnion.clockParams.startFlag = TRUE;
+        Clock_construct(&object->watchdogClk,
+                        busWatchdogCallback,
+                        object->busWatchdog,
+                        &paramsUnion.clockParams);
+    }
+#endif
 
-    I2CSlaveEnable(hwAttrs->baseAddr);
-    I2CSlaveFIFODisable(hwAttrs->baseAddr);
+#if I2CTIVASLAVE_USE_SINKS
+    /* The Swi stages run at the default Swi priority */
+    if (object->sinkIsrCount < object->sinkCount) {
+        Swi_Params_init(&paramsUnion.swiParams);
+        paramsUnion.swiParams.arg0 = (UArg)handle;
+        Swi_construct(&object->sinkSwi, sinkSwiFxn,
+                      &paramsUnion.swiParams, NULL);
+    }
+#endif
 
-    I2CSlaveIntEnableEx(hwAttrs->baseAddr, I2C_SLAVE_INT_DATA);
+    initHw(handle);
 
     /* Return the handle */
     return (handle);
@@ -217,6 +869,10 @@ I2CSlave_Handle I2CTivaSlave_open(I2CSlave_Handle handle, I2CSlave_Params *param
 int I2CTivaSlave_read(I2CSlave_Handle handle, void *buffer, size_t size)
 {
     unsigned int                key;
+    int                         count;
+#if I2CTIVASLAVE_USE_TIMESTAMPS && I2CTIVASLAVE_USE_STATS
+    uint32_t                    latency;
+#endif
     I2CTivaSlave_Object        *object = handle->object;
 
     key = Hwi_disable();
@@ -228,196 +884,2280 @@ int I2CTivaSlave_read(I2CSlave_Handle handle, void *buffer, size_t size)
 
     Hwi_restore(key);
 
-    return (object->readFxns.readTaskFxn(handle));
+    count = object->readFxns->readTaskFxn(handle);
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS && I2CTIVASLAVE_USE_STATS
+    if (count > 0 && object->timestampFxn != NULL &&
+        !object->state.stampLost) {
+        latency = object->timestampFxn() - object->readStamp;
+
+        key = Hwi_disable();
+        if (object->stats.latencyCount == 0 ||
+            latency < object->stats.latencyMin) {
+            object->stats.latencyMin = latency;
+        }
+        if (latency > object->stats.latencyMax) {
+            object->stats.latencyMax = latency;
+        }
+        object->stats.latencyLast = latency;
+        object->stats.latencySum += latency;
+        object->stats.latencyCount++;
+        Hwi_restore(key);
+    }
+#endif
+
+    return (count);
 }
 
 /*
- *  ======== I2CTivaSlave_write ========
+ *  ======== I2CTivaSlave_readTimestamp ========
  */
-int I2CTivaSlave_write(I2CSlave_Handle handle, const void *buffer, size_t size)
+int I2CTivaSlave_readTimestamp(I2CSlave_Handle handle, void *buffer,
+                               size_t size, uint32_t *timestamp)
 {
-    unsigned int                   key;
-    I2CTivaSlave_Object           *object = handle->object;
-    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
-    uint32_t                       writeCount;
-
-    if (!size) {
-        return 0;
-    }
+    int                         count;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    I2CTivaSlave_Object        *object = handle->object;
+#endif
 
-    key = Hwi_disable();
+    count = I2CTivaSlave_read(handle, buffer, size);
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    *timestamp = object->readStamp;
+#else
+    *timestamp = 0;
+#endif
 
-    Log_print1(Diags_USER1, "SLV: try write %d", 1);
+    return (count);
+}
 
-    if (object->writeCount) {
-        Hwi_restore(key);
+/*
+ *  ======== I2CTivaSlave_readBlock ========
+ */
+int I2CTivaSlave_readBlock(I2CSlave_Handle handle, void **block)
+{
+    I2CTivaSlave_Object        *object = handle->object;
 
+    if (object->readFxns->readBlockFxn == NULL) {
         return (I2CSLAVE_ERROR);
     }
 
-    /* Save the data to be written and restore interrupts. */
-    object->writeBuf = buffer;
-    object->writeSize = size;
-    object->writeCount = size;
+    return (object->readFxns->readBlockFxn(handle, block));
+}
 
-    Hwi_restore(key);
+/*
+ *  ======== I2CTivaSlave_readBroadcast ========
+ */
+int I2CTivaSlave_readBroadcast(I2CSlave_Handle handle, void **frame)
+{
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    unsigned int                   key;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_BcastFrame       *bcastFrame;
 
-    if (I2CSlaveStatus(hwAttrs->baseAddr) & I2C_SLAVE_ACT_TREQ) {
-        /* Stop clock if Write is pending */
-        if (Clock_isActive(Clock_handle(&object->writeTimeoutClk))) {
-            Clock_stop(Clock_handle(&object->writeTimeoutClk));
-            Log_print1(Diags_USER1, "SLV: pendw %d", 1);
-            writeData(handle);
-        }
+    if (!object->state.bcastSubscribed) {
+        *frame = NULL;
+        return (I2CSLAVE_ERROR);
     }
 
-    Semaphore_pend(Semaphore_handle(&object->writeSem), BIOS_NO_WAIT);
+    /*
+     * bcastSem is binary and is posted for frames of any port, so the next
+     * frame is always checked before pending.
+     */
+    while (true) {
+        key = Hwi_disable();
+        if (object->bcastRead != hwAttrs->broadcast->seq) {
+            bcastFrame = bcastFrameOf(hwAttrs->broadcast, object->bcastRead);
+            if (bcastFrame->ready) {
+                object->bcastRead++;
+                Hwi_restore(key);
 
-    if (object->writeCount) {
-        /* If writeMode is blocking, block and get the state. */
-        /* Pend on semaphore and wait for Hwi to finish. */
-        if (!Semaphore_pend(Semaphore_handle(&object->writeSem),
-                object->writeTimeout)) {
-            Log_print1(Diags_USER1, "SLV: timeout %d", 1);
+                *frame = bcastFrame->data;
+                return (bcastFrame->count);
+            }
+        }
+        Hwi_restore(key);
+
+        if (!Semaphore_pend(Semaphore_handle(&object->bcastSem),
+                object->readTimeout)) {
+            Log_print1(Diags_USER1, "SLV: broadcast tou %d", 1);
+            *frame = NULL;
+            return (I2CSLAVE_ERROR);
+        }
+    }
+#else
+    (void)handle;
+    *frame = NULL;
+    return (I2CSLAVE_ERROR);
+#endif
+}
+
+/*
+ *  ======== I2CTivaSlave_releaseBlock ========
+ */
+void I2CTivaSlave_releaseBlock(I2CSlave_Handle handle, void *block)
+{
+    I2CTivaSlave_Object        *object = handle->object;
+
+    if (object->readFxns->releaseBlockFxn != NULL) {
+        object->readFxns->releaseBlockFxn(handle, block);
+    }
+}
+
+/*
+ *  ======== I2CTivaSlave_releaseBroadcast ========
+ *  Frames must be given back in the order they were read; the frame is
+ *  freed once every subscriber gave it back.
+ */
+void I2CTivaSlave_releaseBroadcast(I2CSlave_Handle handle, void *frame)
+{
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    unsigned int                   key;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_BcastFrame       *bcastFrame;
+
+    key = Hwi_disable();
+    if (object->state.bcastSubscribed &&
+        object->bcastRelease != object->bcastRead) {
+        bcastFrame = bcastFrameOf(hwAttrs->broadcast, object->bcastRelease);
+        if (frame == bcastFrame->data) {
+            object->bcastRelease++;
+            bcastFrame->refs--;
+            bcastFree(hwAttrs->broadcast);
+        }
+    }
+    Hwi_restore(key);
+#else
+    (void)handle;
+    (void)frame;
+#endif
+}
+
+/*
+ *  ======== I2CTivaSlave_write ========
+ */
+int I2CTivaSlave_write(I2CSlave_Handle handle, const void *buffer, size_t size)
+{
+    unsigned int                   key;
+    I2CTivaSlave_Object           *object = handle->object;
+    uint32_t                       writeCount;
+
+    if (!size) {
+        return 0;
+    }
+
+    key = Hwi_disable();
+
+    Log_print1(Diags_USER1, "SLV: try write %d", 1);
+
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+    dropIsrReply(handle);
+#endif
+
+    if (object->writeCount) {
+        Hwi_restore(key);
+
+        return (I2CSLAVE_ERROR);
+    }
+
+    /* Save the data to be written and restore interrupts. */
+    object->writeBuf = buffer;
+    object->writeSize = size;
+    object->writeCount = size;
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+    object->state.isrReply = false;
+#endif
+    object->state.writeActive = true;
+
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+    if (object->state.pendSample) {
+        adaptPendTimeout(handle);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    /* Only a reply to the one write waiting for it is known to match it */
+    if (object->lastCmdSize && object->cmdPending == 1) {
+        cacheStore(handle, buffer, size);
+    }
+    object->lastCmdSize = 0;
+    if (object->cmdPending) {
+        object->cmdPending--;
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /* With no master read in progress the first byte waits in the FIFO */
+    if (!object->state.txActive) {
+        stageData(handle);
+    }
+#endif
+
+    Hwi_restore(key);
+
+    resumeWrite(handle);
+
+    Semaphore_pend(Semaphore_handle(&object->writeSem), BIOS_NO_WAIT);
+
+    if (object->writeCount) {
+        /* If writeMode is blocking, block and get the state. */
+        /* Pend on semaphore and wait for Hwi to finish. */
+        if (!Semaphore_pend(Semaphore_handle(&object->writeSem),
+                object->writeTimeout)) {
+            Log_print1(Diags_USER1, "SLV: timeout %d", 1);
 
         } else {
             Log_print1(Diags_USER1, "SLV: write finish %d", 1);
         }
     }
 
-    writeCount = object->writeCount;
+    key = Hwi_disable();
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /* A byte still in the FIFO was not sent */
+    unstageData(handle);
+#endif
+    writeCount = object->writeSize - object->writeCount;
+    object->writeCount = 0;
+    object->state.writeActive = false;
+    Hwi_restore(key);
+
+    return (writeCount);
+}
+
+/*
+ *  ======== I2CTivaSlave_transact ========
+ */
+int I2CTivaSlave_transact(I2CSlave_Handle handle, void *rxBuf, size_t rxLen,
+                          I2CSlave_CmdFxn responder)
+{
+#if I2CTIVASLAVE_USE_TRANSACT
+    unsigned int                   key;
+    int                            count;
+    unsigned int                   timeout;
+    unsigned int                   wait = BIOS_WAIT_FOREVER;
+    uint32_t                       start;
+    uint32_t                       elapsed;
+    unsigned char                  readIn;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    if (!rxLen || responder == NULL) {
+        return (I2CSLAVE_ERROR);
+    }
+
+    /* Clear a post left over from an earlier write */
+    Semaphore_pend(Semaphore_handle(&object->writeSem), BIOS_NO_WAIT);
+
+    key = Hwi_disable();
+
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+    dropIsrReply(handle);
+#endif
+
+    if (object->writeCount || object->state.writeActive) {
+        Hwi_restore(key);
+
+        return (I2CSLAVE_ERROR);
+    }
+
+    object->xactBuf = rxBuf;
+    object->xactSize = rxLen;
+    object->xactCount = 0;
+    object->xactFxn = responder;
+    object->writeSize = 0;
+    object->state.writeActive = true;
+
+    /*
+     * Bytes received before the call are the start of the command. In packet
+     * mode they belong to packets and are left for I2CSlave_read().
+     */
+    while (object->readMode != I2CSLAVE_MODE_PACKET &&
+           object->xactCount < rxLen &&
+           RingBuf_get(&object->ringBuffer, &readIn) >= 0) {
+        object->xactBuf[object->xactCount++] = readIn;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+        object->readSeq++;
+#endif
+    }
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+    releaseHeld(handle);
+#endif
+    if (object->xactCount == rxLen) {
+        runTransact(handle);
+    }
+
+    Hwi_restore(key);
+
+    /* The master may already be waiting for the reply */
+    resumeWrite(handle);
+
+    /* One wait covers both the command and the reply */
+    if (object->readTimeout == (unsigned int)I2CSLAVE_WAIT_FOREVER ||
+        object->writeTimeout == (unsigned int)I2CSLAVE_WAIT_FOREVER) {
+        timeout = BIOS_WAIT_FOREVER;
+    }
+    else {
+        timeout = object->readTimeout + object->writeTimeout;
+    }
+
+    /*
+     * writeSem is also posted at the end of the previous master read, which
+     * may come after this call started, so a post alone does not mean the
+     * transact is done.
+     */
+    start = Clock_getTicks();
+    while (object->xactBuf != NULL || object->writeCount) {
+        if (timeout != BIOS_WAIT_FOREVER) {
+            elapsed = Clock_getTicks() - start;
+            if (elapsed >= timeout) {
+                break;
+            }
+            wait = timeout - elapsed;
+        }
+        if (!Semaphore_pend(Semaphore_handle(&object->writeSem), wait)) {
+            break;
+        }
+    }
+
+    key = Hwi_disable();
+    if (object->xactBuf != NULL) {
+        Log_print1(Diags_USER1, "SLV: transact tou %d", object->xactCount);
+        count = I2CSLAVE_ERROR;
+    }
+    else {
+#if I2CTIVASLAVE_USE_PRESTAGE
+        unstageData(handle);
+#endif
+        count = object->writeSize - object->writeCount;
+    }
+    object->xactBuf = NULL;
     object->writeCount = 0;
-    return (object->writeSize - writeCount);
+    object->state.writeActive = false;
+    Hwi_restore(key);
+
+    return (count);
+#else
+    (void)handle;
+    (void)rxBuf;
+    (void)rxLen;
+    (void)responder;
+    return (I2CSLAVE_ERROR);
+#endif
+}
+
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+/*
+ *  ======== adaptPendTimeout ========
+ *  Updates the estimate of the pendPercentile-th percentile of the time the
+ *  application takes to answer a master write, and sets the write pending
+ *  timeout one tick above it. The estimate starts at the first response
+ *  time, then moves up by p and down by 100 - p parts of a step, so it
+ *  settles where p percent of the response times are below it. Steps are
+ *  an eighth of the estimate. Called with interrupts disabled.
+ */
+static void adaptPendTimeout(I2CSlave_Handle handle)
+{
+    uint32_t                       sample;
+    uint32_t                       step;
+    uint32_t                       timeout;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    object->state.pendSample = false;
+    sample = (Clock_getTicks() - object->cmdEndTick) << 4;
+    step = (object->pendEstimate >> 3) + 4;
+
+    if (!object->state.pendSeeded) {
+        object->pendEstimate = sample;
+        object->state.pendSeeded = true;
+    }
+    else if (sample > object->pendEstimate) {
+        object->pendEstimate += (step * object->pendPercentile + 99) / 100;
+    }
+    else if (sample < object->pendEstimate) {
+        step = (step * (100 - object->pendPercentile) + 99) / 100;
+        object->pendEstimate = object->pendEstimate > step ?
+            object->pendEstimate - step : 0;
+    }
+
+    timeout = ((object->pendEstimate + 15) >> 4) + 1;
+    if (timeout < object->pendMin) {
+        timeout = object->pendMin;
+    }
+    if (timeout > object->pendMax) {
+        timeout = object->pendMax;
+    }
+
+    object->writePendTimeout = timeout;
+#if I2CTIVASLAVE_USE_STATS
+    object->stats.txPendTimeout = timeout;
+#endif
+    STATS_ADD(object, txPendSamples, 1);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+/*
+ *  ======== bcastEndFrame ========
+ *  Called by the ISR when the general call frame being received ends. The
+ *  frame is handed to every subscriber at once, as the same buffer.
+ */
+static void bcastEndFrame(I2CSlave_Handle handle)
+{
+    unsigned int                   key;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_Object           *subscriber;
+
+    Log_print1(Diags_USER1, "SLV: general call %d", object->bcastFill->count);
+
+    /* The ring is shared with the interrupts of the other ports */
+    key = Hwi_disable();
+    object->bcastFill->ready = true;
+    object->bcastFill = NULL;
+    STATS_ADD(object, bcastFrames, 1);
+    for (subscriber = hwAttrs->broadcast->subscribers; subscriber != NULL;
+         subscriber = subscriber->bcastNext) {
+        Semaphore_post(Semaphore_handle(&subscriber->bcastSem));
+    }
+    bcastFree(hwAttrs->broadcast);
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== bcastFrameOf ========
+ *  Returns the frame numbered seq, which must still be in use.
+ */
+static I2CTivaSlave_BcastFrame *bcastFrameOf(I2CTivaSlave_Broadcast *broadcast,
+                                             uint32_t seq)
+{
+    return (&broadcast->frames[(broadcast->head + seq -
+        broadcast->frames[broadcast->head].seq) % I2CTIVASLAVE_BCAST_DEPTH]);
+}
+
+/*
+ *  ======== bcastFree ========
+ *  Frees the oldest frames that are complete and were given back by every
+ *  subscriber. Called with interrupts disabled.
+ */
+static void bcastFree(I2CTivaSlave_Broadcast *broadcast)
+{
+    I2CTivaSlave_BcastFrame       *frame;
+
+    while (broadcast->count) {
+        frame = &broadcast->frames[broadcast->head];
+        if (!frame->ready || frame->refs) {
+            break;
+        }
+        broadcast->head = (broadcast->head + 1) % I2CTIVASLAVE_BCAST_DEPTH;
+        broadcast->count--;
+    }
+}
+
+/*
+ *  ======== bcastReceive ========
+ *  Called by the ISR for every byte of a general call. The first byte takes
+ *  the next frame of the shared ring, with one reference per subscriber.
+ *  Without a free frame the general call is dropped, and bytes past the
+ *  frame size are cut.
+ */
+static void bcastReceive(I2CSlave_Handle handle, uint32_t i2cstatus)
+{
+    unsigned int                   key;
+    unsigned char                  readIn;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_Broadcast        *broadcast = hwAttrs->broadcast;
+    I2CTivaSlave_BcastFrame       *frame;
+
+    readIn = I2CSlaveDataGet(hwAttrs->baseAddr);
+    STATS_ADD(object, rxBytes, 1);
+    object->state.rxFrame = true;
+
+    if (i2cstatus & I2C_SCSR_FBR) {
+        if (object->bcastFill != NULL) {
+            bcastEndFrame(handle);
+        }
+
+        key = Hwi_disable();
+        if (broadcast->count < I2CTIVASLAVE_BCAST_DEPTH) {
+            frame = &broadcast->frames[(broadcast->head + broadcast->count) %
+                I2CTIVASLAVE_BCAST_DEPTH];
+            frame->seq = broadcast->seq++;
+            frame->refs = broadcast->subscriberCount;
+            frame->ready = false;
+            frame->count = 0;
+            broadcast->count++;
+            object->bcastFill = frame;
+        }
+        Hwi_restore(key);
+    }
+
+    if (object->bcastFill == NULL ||
+        object->bcastFill->count == I2CTIVASLAVE_BCAST_SIZE) {
+        STATS_ADD(object, bcastOverruns, 1);
+        return;
+    }
+
+    object->bcastFill->data[object->bcastFill->count++] = readIn;
+}
+
+/*
+ *  ======== bcastUnsubscribe ========
+ *  Takes a closing instance off the subscriber list and gives back the
+ *  frames it did not release.
+ */
+static void bcastUnsubscribe(I2CSlave_Handle handle)
+{
+    unsigned int                   key;
+    uint32_t                       seq;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_Broadcast        *broadcast = hwAttrs->broadcast;
+    I2CTivaSlave_Object          **link;
+
+    key = Hwi_disable();
+    for (link = &broadcast->subscribers; *link != object;
+         link = &(*link)->bcastNext) {
+    }
+    *link = object->bcastNext;
+    broadcast->subscriberCount--;
+
+    for (seq = object->bcastRelease; seq != broadcast->seq; seq++) {
+        bcastFrameOf(broadcast, seq)->refs--;
+    }
+    bcastFree(broadcast);
+    object->state.bcastSubscribed = false;
+    Hwi_restore(key);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_WATCHDOG
+/*
+ *  ======== busWatchdogCallback ========
+ *  Resets the slave if the bus has been held or a transaction left open
+ *  with no slave interrupt for a whole watchdog period. A byte held for
+ *  backpressure and a master read waiting for the write pending timeout
+ *  are the driver's own doing and are left alone. Lines still low after a
+ *  reset are held by another device, so there is one reset until the bus
+ *  is active again.
+ */
+static Void busWatchdogCallback(UArg arg)
+{
+    unsigned int                   key;
+    bool                           stuck;
+    I2CTivaSlave_Object           *object = ((I2CSlave_Handle)arg)->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = ((I2CSlave_Handle)arg)->hwAttrs;
+
+    key = Hwi_disable();
+
+    stuck = Clock_getTicks() - object->activityTick >= object->busWatchdog &&
+        !object->state.busReset &&
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+        !object->state.rxHeld &&
+#endif
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
+        !Clock_isActive(Clock_handle(&object->writeTimeoutClk)) &&
+#else
+        !object->state.txPending &&
+#endif
+        (object->state.frameOpen ||
+         (I2CSlaveStatus(hwAttrs->baseAddr) &
+             (I2C_SLAVE_ACT_RREQ | I2C_SLAVE_ACT_TREQ)) ||
+         (I2CMasterLineStateGet(hwAttrs->baseAddr) &
+             (I2C_MBMON_SCL | I2C_MBMON_SDA)) !=
+             (I2C_MBMON_SCL | I2C_MBMON_SDA));
+    if (stuck) {
+        recoverBus((I2CSlave_Handle)arg);
+    }
+
+    Hwi_restore(key);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+/*
+ *  ======== cacheEndFrame ========
+ *  Called by the ISR on a START or STOP. A master write that matches a cache
+ *  entry is answered with its reply, unless the task has a write of its own
+ *  in progress; otherwise the bytes held back go to the read mode and the
+ *  write waits for the task's reply.
+ */
+static void cacheEndFrame(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_CacheEntry       *entry = NULL;
+
+    if (!object->keySize) {
+        return;
+    }
+
+    if (object->state.keyHold && !object->state.writeActive &&
+        !object->writeCount) {
+        entry = cacheFind(handle, object->keySize, false);
+    }
+
+    if (entry != NULL) {
+        Log_print1(Diags_USER1, "SLV: cache hit %d", entry->replySize);
+        memcpy(object->replyBuf, entry->reply, entry->replySize);
+        object->writeBuf = object->replyBuf;
+        object->writeSize = entry->replySize;
+        object->writeCount = entry->replySize;
+        object->state.isrReply = true;
+        object->lastCmdSize = 0;
+        STATS_ADD(object, cacheHits, 1);
+    }
+    else {
+        /*
+         * With an earlier write still unanswered, the next I2CSlave_write()
+         * may answer either one, so neither is cached.
+         */
+        object->cmdPending++;
+        object->lastCmdSize = object->cmdPending == 1 &&
+            object->keySize <= I2CTIVASLAVE_CMD_SIZE ? object->keySize : 0;
+        memcpy(object->lastCmd, object->keyBuf, object->lastCmdSize);
+        cacheFlush(handle);
+    }
+
+    object->keySize = 0;
+    object->state.keyHold = true;
+}
+
+/*
+ *  ======== cacheFind ========
+ *  Returns the live entry whose command is keyBuf, or starts with it if
+ *  prefix is set, or NULL.
+ */
+static I2CTivaSlave_CacheEntry *cacheFind(I2CSlave_Handle handle,
+                                          size_t size, bool prefix)
+{
+    unsigned int                   i;
+    uint32_t                       now = Clock_getTicks();
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_CacheEntry       *entry;
+
+    for (i = 0; i < hwAttrs->replyCacheCount; i++) {
+        entry = &hwAttrs->replyCache[i];
+        if (entry->cmdSize &&
+            now - entry->tick < object->cacheLifetime &&
+            (prefix ? entry->cmdSize >= size : entry->cmdSize == size) &&
+            memcmp(entry->cmd, object->keyBuf, size) == 0) {
+            return (entry);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== cacheFlush ========
+ *  Passes the bytes held back by cacheReceive() to the read mode.
+ */
+static void cacheFlush(I2CSlave_Handle handle)
+{
+    size_t                         i;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    if (object->state.keyHold) {
+        object->state.keyHold = false;
+        for (i = 0; i < object->keySize; i++) {
+            deliverData(handle, object->keyBuf[i]);
+        }
+    }
+}
+
+/*
+ *  ======== cacheReceive ========
+ *  Called by the ISR for every received byte. Returns true if the byte is
+ *  held back because the master write so far matches a cache entry.
+ */
+static bool cacheReceive(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+    if (!object->cacheLifetime) {
+        return (false);
+    }
+
+    if (object->keySize < I2CTIVASLAVE_CMD_SIZE) {
+        object->keyBuf[object->keySize] = data;
+    }
+    object->keySize++;
+
+    if (!object->state.keyHold) {
+        return (false);
+    }
+
+    if (object->keySize <= I2CTIVASLAVE_CMD_SIZE &&
+        cacheFind(handle, object->keySize, true) != NULL) {
+        return (true);
+    }
+
+    /* Not a retry: release what was held, then this byte */
+    object->keySize--;
+    cacheFlush(handle);
+    object->keySize++;
+
+    return (false);
+}
+
+/*
+ *  ======== cacheStore ========
+ *  Remembers the reply to the last master write, in the entry of the same
+ *  command if there is one, else in a free or the oldest entry. Called with
+ *  interrupts disabled.
+ */
+static void cacheStore(I2CSlave_Handle handle, const void *reply, size_t size)
+{
+    unsigned int                   i;
+    uint32_t                       now = Clock_getTicks();
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+    I2CTivaSlave_CacheEntry       *entry = NULL;
+    I2CTivaSlave_CacheEntry       *oldest = &hwAttrs->replyCache[0];
+    I2CTivaSlave_CacheEntry       *candidate;
+
+    if (size > I2CTIVASLAVE_REPLY_SIZE) {
+        object->lastCmdSize = 0;
+        return;
+    }
+
+    for (i = 0; i < hwAttrs->replyCacheCount; i++) {
+        candidate = &hwAttrs->replyCache[i];
+        if (candidate->cmdSize == object->lastCmdSize &&
+            memcmp(candidate->cmd, object->lastCmd,
+                object->lastCmdSize) == 0) {
+            entry = candidate;
+            break;
+        }
+        if (oldest->cmdSize && (!candidate->cmdSize ||
+            now - candidate->tick > now - oldest->tick)) {
+            oldest = candidate;
+        }
+    }
+    if (entry == NULL) {
+        entry = oldest;
+    }
+
+    entry->tick = now;
+    entry->cmdSize = object->lastCmdSize;
+    entry->replySize = size;
+    memcpy(entry->cmd, object->lastCmd, object->lastCmdSize);
+    memcpy(entry->reply, reply, size);
+    object->lastCmdSize = 0;
+}
+#endif
+
+#if I2CTIVASLAVE_USE_CMD_TABLE
+/*
+ *  ======== dispatchCmd ========
+ *  Called by the ISR for every received byte. Returns true if the byte
+ *  belongs to a command from the dispatch table, in which case it must not
+ *  be placed into the ring buffer.
+ */
+static bool dispatchCmd(I2CSlave_Handle handle, uint32_t i2cstatus,
+                        unsigned char data)
+{
+    size_t                         i;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    if (i2cstatus & I2C_SCSR_FBR) {
+        /* A new transaction always starts with a fresh opcode */
+        object->cmd = NULL;
+
+        for (i = 0; i < object->cmdCount; i++) {
+            if (object->cmdTable[i].opcode == data) {
+                object->cmd = &object->cmdTable[i];
+                object->cmdSize = 0;
+                break;
+            }
+        }
+    }
+
+    if (object->cmd == NULL) {
+        return (false);
+    }
+
+    object->cmdBuf[object->cmdSize++] = data;
+
+    if (object->cmdSize == (size_t)object->cmd->argSize + 1) {
+        runCmd(handle);
+    }
+
+    return (true);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+/*
+ *  ======== dropIsrReply ========
+ *  Discards a reply staged by the ISR that the master did not start to
+ *  read, so it does not hold the transmit path against the next command
+ *  or the task's I2CSlave_write(). Called from the ISR or with interrupts
+ *  disabled.
+ */
+static void dropIsrReply(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+    if (!object->state.isrReply || object->state.txActive) {
+        return;
+    }
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+    unstageData(handle);
+#endif
+    if (object->writeCount) {
+        Log_print1(Diags_USER1, "SLV: drop reply %d", object->writeCount);
+        STATS_ADD(object, txDiscarded, object->writeCount);
+        object->writeCount = 0;
+    }
+    object->state.isrReply = false;
+}
+#endif
+
+/*
+ *  ======== deliverData ========
+ *  Passes a received byte to the sink stages, if any, or to the read mode.
+ */
+static void deliverData(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+#if I2CTIVASLAVE_USE_SINKS
+    if (object->sinkCount) {
+        sinkReceive(handle, data);
+        return;
+    }
+#endif
+    object->readFxns->readIsrFxn(handle, data);
+}
+
+/*
+ *  ======== endReadFrame ========
+ *  Called by the ISR on START and STOP conditions. The read mode sees the
+ *  end of the master write after the last of its bytes, which may still be
+ *  in the sink stages.
+ */
+static void endReadFrame(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+#if I2CTIVASLAVE_USE_SINKS
+    if (object->sinkCount) {
+        if (object->state.sinkFrame) {
+            sinkFlush(handle, true);
+        }
+        return;
+    }
+#endif
+    if (object->readFxns->endIsrFxn != NULL) {
+        object->readFxns->endIsrFxn(handle);
+    }
+}
+
+/*
+ *  ======== endWrite ========
+ *  Called by the ISR when a master read ends with a STOP or repeated START.
+ *  Bytes the master did not read are discarded, so they are not sent in the
+ *  next transaction, and a blocked I2CSlave_write() returns at once with
+ *  the number of bytes sent.
+ */
+static void endWrite(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+    object->state.txActive = false;
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /* The byte queued after the last one read is not sent */
+    unstageData(handle);
+#endif
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
+    Clock_stop(Clock_handle(&object->writeTimeoutClk));
+#else
+    object->state.txPending = false;
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    /* The master took its answer; a later write cannot be matched to one */
+    object->lastCmdSize = 0;
+    object->cmdPending = 0;
+#endif
+
+    if (object->writeCount) {
+        Log_print1(Diags_USER1, "SLV: short read %d", object->writeCount);
+        STATS_ADD(object, txDiscarded, object->writeCount);
+        object->writeSize -= object->writeCount;
+        object->writeCount = 0;
+    }
+
+    /* Also wakes a transact waiting for its reply to be read */
+    WRITE_CALLBACK(object)(handle, (void *)object->writeBuf, object->writeSize);
+}
+
+/*
+ *  ======== initHw ========
+ *  Configures the slave for the opened instance and enables it.
+ */
+static void initHw(I2CSlave_Handle handle)
+{
+    uint32_t                       intFlags;
+    uint32_t                       fifoFlags = 0;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    I2CSlaveInit(hwAttrs->baseAddr, object->slaveAddress);
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /* The second own address is the general call address */
+    if (object->state.generalCall) {
+        I2CSlaveAddressSet(hwAttrs->baseAddr, 1, 0x00);
+    }
+#endif
+
+    /*
+     * START and STOP end frames in the frame based modes, and end master
+     * reads that take fewer bytes than were written.
+     */
+    intFlags = I2C_SLAVE_INT_DATA | I2C_SLAVE_INT_START | I2C_SLAVE_INT_STOP;
+
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+    /*
+     * In High-speed mode a byte takes under 3 us, less than an interrupt per
+     * byte. Received bytes collect in the FIFO, which interrupts once it
+     * holds a few of them and holds SCL when full. Master reads are still
+     * served a byte at a time.
+     */
+    if (object->state.highSpeed) {
+        intFlags |= I2C_SLAVE_INT_RX_FIFO_REQ;
+    }
+#endif
+
+    /* Enable I2CSlave and its interrupt. */
+    I2CSlaveIntClearEx(hwAttrs->baseAddr, intFlags);
+
+    I2CSlaveEnable(hwAttrs->baseAddr);
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+    if (object->state.highSpeed) {
+        I2CRxFIFOConfigSet(hwAttrs->baseAddr,
+            I2C_FIFO_CFG_RX_SLAVE | I2CTIVASLAVE_RX_FIFO_TRIGGER);
+        I2CRxFIFOFlush(hwAttrs->baseAddr);
+        fifoFlags |= I2C_SLAVE_RX_FIFO_ENABLE;
+    }
+#endif
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /*
+     * Unlike the data register, the transmit FIFO keeps a byte written
+     * before the master asks for it, and a received byte does not replace
+     * it. Its request is raised once it is empty again.
+     */
+    if (object->txPrestage) {
+        I2CTxFIFOConfigSet(hwAttrs->baseAddr,
+            I2C_FIFO_CFG_TX_SLAVE | I2C_FIFO_CFG_TX_NO_TRIG);
+        I2CTxFIFOFlush(hwAttrs->baseAddr);
+        I2CSlaveIntClearEx(hwAttrs->baseAddr, I2C_SLAVE_INT_TX_FIFO_REQ);
+        fifoFlags |= I2C_SLAVE_TX_FIFO_ENABLE;
+    }
+#endif
+    if (fifoFlags) {
+        I2CSlaveFIFOEnable(hwAttrs->baseAddr, fifoFlags);
+    }
+    else {
+        I2CSlaveFIFODisable(hwAttrs->baseAddr);
+    }
+
+    I2CSlaveIntEnableEx(hwAttrs->baseAddr, intFlags);
+}
+
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
+/*
+ *  ======== readBlockingTimeout ========
+ */
+static Void readBlockingTimeout(UArg arg)
+{
+    I2CTivaSlave_Object *object = ((I2CSlave_Handle)arg)->object;
+    object->state.bufTimeout = true;
+    Semaphore_post(Semaphore_handle(&object->readSem));
+}
+#endif
+
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
+/*
+ *  ======== writePendingTimeoutCallback ========
+ */
+static Void writePendingTimeoutCallback(UArg arg)
+{
+    I2CTivaSlave_Object *object = ((I2CSlave_Handle)arg)->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = ((I2CSlave_Handle)arg)->hwAttrs;
+
+    if (I2CSlaveStatus(hwAttrs->baseAddr) & I2C_SLAVE_ACT_TREQ) {
+        Log_print1(Diags_USER1, "SLV: reset write %d", 1);
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+        /* With the transmit FIFO on, the data register is not sent */
+        if (object->txPrestage) {
+            I2CFIFODataPut(hwAttrs->baseAddr, 0);
+        }
+        else
+#endif
+        {
+            I2CSlaveDataPut(hwAttrs->baseAddr, 0);
+        }
+        STATS_ADD(object, txStuffed, 1);
+    }
+
+    Clock_stop(Clock_handle(&object->writeTimeoutClk));
+}
+#endif
+
+/*
+ *  ======== readIsrBinaryBlocking ========
+ *  Function that is called by the ISR
+ */
+static bool readIsrBinaryBlocking(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+    /* The burst path traces once per burst */
+    if (!object->state.highSpeed)
+#endif
+    {
+        Log_print1(Diags_USER1, "SLV: read in isr 0x%x", data);
+    }
+
+    if (!putRing(handle, data)) {
+        Log_print1(Diags_USER1, "SLV: ring full %d", 1);
+        STATS_ADD(object, rxOverruns, 1);
+        return (false);
+    }
+
+    if (object->state.callCallback) {
+        object->state.callCallback = false;
+        READ_CALLBACK(object)(handle, NULL, 0);
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== putRing ========
+ *  Puts a received byte into the ring buffer and queues the timestamp of
+ *  its frame if it is the first one stored. Returns false if the ring is
+ *  full.
+ */
+static bool putRing(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    I2CTivaSlave_Stamp            *stamp;
+#endif
+
+    if (RingBuf_put(&object->ringBuffer, data) == -1) {
+        return (false);
+    }
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    /*
+     * Remember where the frame starts. The oldest stamps are the ones the
+     * next reads need, so when full the newest entry is turned into a
+     * marker instead: the frames from it on are read with no known time.
+     */
+    if (object->state.stampPending) {
+        object->state.stampPending = false;
+        if (object->stampCount == I2CTIVASLAVE_STAMP_DEPTH) {
+            stamp = &object->stamps[(object->stampHead +
+                I2CTIVASLAVE_STAMP_DEPTH - 1) % I2CTIVASLAVE_STAMP_DEPTH];
+            if (!stamp->lost) {
+                stamp->lost = true;
+                STATS_ADD(object, stampDrops, 1);
+            }
+            STATS_ADD(object, stampDrops, 1);
+        }
+        else {
+            stamp = &object->stamps[(object->stampHead + object->stampCount) %
+                I2CTIVASLAVE_STAMP_DEPTH];
+            stamp->time = object->frameStamp;
+            stamp->seq = object->rxSeq;
+            stamp->lost = false;
+            object->stampCount++;
+        }
+    }
+    object->rxSeq++;
+#endif
+
+    return (true);
+}
+
+#if I2CTIVASLAVE_USE_POOL
+/*
+ *  ======== readIsrPool ========
+ *  Function that is called by the ISR in pool mode. The first byte of a
+ *  transaction takes a block from the free queue.
+ */
+static bool readIsrPool(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    if (object->poolFill == NULL) {
+        if (object->state.poolDrop) {
+            STATS_ADD(object, rxOverruns, 1);
+            return (false);
+        }
+
+        if (Queue_empty(Queue_handle(&object->poolFree))) {
+            Log_print1(Diags_USER1, "SLV: pool empty %d", 1);
+            object->state.poolDrop = true;
+            STATS_ADD(object, rxOverruns, 1);
+            return (false);
+        }
+
+        object->poolFill = Queue_dequeue(Queue_handle(&object->poolFree));
+        object->poolFill->count = 0;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+        object->poolFill->timestamp = object->frameStamp;
+#endif
+    }
+
+    if (object->poolFill->count == hwAttrs->poolBlockSize) {
+        Log_print1(Diags_USER1, "SLV: block full %d", 1);
+        STATS_ADD(object, rxOverruns, 1);
+        return (false);
+    }
+
+    object->poolFill->data[object->poolFill->count++] = data;
+
+    return (true);
+}
+
+/*
+ *  ======== endIsrPool ========
+ *  Hands the filled block to the application at the end of a transaction.
+ */
+static void endIsrPool(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+    object->state.poolDrop = false;
+
+    if (object->poolFill != NULL) {
+        Queue_enqueue(Queue_handle(&object->poolReady),
+            &object->poolFill->elem);
+        object->poolFill = NULL;
+        READ_CALLBACK(object)(handle, NULL, 0);
+    }
+}
+
+/*
+ *  ======== readBlockPool ========
+ */
+static int readBlockPool(I2CSlave_Handle handle, void **block)
+{
+    uintptr_t                      key;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_PoolBlock        *poolBlock;
+
+    /*
+     * readSem is binary and may have been posted for a block that was already
+     * taken, so the ready queue is always checked before pending.
+     */
+    while (true) {
+        key = Hwi_disable();
+        if (!Queue_empty(Queue_handle(&object->poolReady))) {
+            poolBlock = Queue_dequeue(Queue_handle(&object->poolReady));
+            poolBlock->inUse = true;
+            Hwi_restore(key);
+
+            *block = poolBlock->data;
+            return (poolBlock->count);
+        }
+        Hwi_restore(key);
+
+        if (!Semaphore_pend(Semaphore_handle(&object->readSem),
+                object->readTimeout)) {
+            Log_print1(Diags_USER1, "SLV: block tou %d", 1);
+            *block = NULL;
+            return (I2CSLAVE_ERROR);
+        }
+    }
+}
+
+/*
+ *  ======== releaseBlockPool ========
+ */
+static void releaseBlockPool(I2CSlave_Handle handle, void *block)
+{
+    uintptr_t                      key;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_PoolBlock        *poolBlock;
+
+    poolBlock = poolBlockOf(handle, block);
+    if (poolBlock == NULL) {
+        return;
+    }
+
+    /* A second release would queue the block twice */
+    key = Hwi_disable();
+    if (!poolBlock->inUse) {
+        Hwi_restore(key);
+        Log_print1(Diags_USER1, "SLV: block not in use %d", 1);
+        return;
+    }
+    poolBlock->inUse = false;
+    Queue_enqueue(Queue_handle(&object->poolFree), &poolBlock->elem);
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== poolBlockOf ========
+ *  Returns the descriptor of a block handed out by readBlockPool(), or NULL
+ *  if block is not the start of a block of the pool.
+ */
+static I2CTivaSlave_PoolBlock *poolBlockOf(I2CSlave_Handle handle, void *block)
+{
+    size_t                         offset;
+    size_t                         index;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    if (block == NULL || (unsigned char *)block < hwAttrs->poolBufPtr) {
+        return (NULL);
+    }
+
+    offset = (unsigned char *)block - hwAttrs->poolBufPtr;
+    index = offset / hwAttrs->poolBlockSize;
+    if (offset % hwAttrs->poolBlockSize != 0 ||
+        index >= hwAttrs->poolBlockCount) {
+        return (NULL);
+    }
+
+    return (&hwAttrs->poolBlocks[index]);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_STREAM
+/*
+ *  ======== readIsrStream ========
+ *  Function that is called by the ISR in stream mode. Bytes fill the
+ *  buffers back to back; each full buffer wakes the reader.
+ */
+static bool readIsrStream(I2CSlave_Handle handle, unsigned char data)
+{
+    unsigned char                 *buffer;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    /* Every buffer is full or held by the application */
+    if (object->streamTaken + object->streamReady == object->streamBufCount) {
+        STATS_ADD(object, rxOverruns, 1);
+        return (false);
+    }
+
+    buffer = object->streamBufs[(object->streamHead + object->streamTaken +
+        object->streamReady) % object->streamBufCount];
+    buffer[object->streamPos++] = data;
+
+    if (object->streamPos == object->streamBufSize) {
+        object->streamPos = 0;
+        object->streamReady++;
+        READ_CALLBACK(object)(handle, NULL, 0);
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== readBlockStream ========
+ */
+static int readBlockStream(I2CSlave_Handle handle, void **block)
+{
+    uintptr_t                      key;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    /* As in readBlockPool(), readSem may be left over from a taken buffer */
+    while (true) {
+        key = Hwi_disable();
+        if (object->streamReady) {
+            *block = object->streamBufs[(object->streamHead +
+                object->streamTaken) % object->streamBufCount];
+            object->streamTaken++;
+            object->streamReady--;
+            Hwi_restore(key);
+
+            return (object->streamBufSize);
+        }
+        Hwi_restore(key);
+
+        if (!Semaphore_pend(Semaphore_handle(&object->readSem),
+                object->readTimeout)) {
+            Log_print1(Diags_USER1, "SLV: stream tou %d", 1);
+            *block = NULL;
+            return (I2CSLAVE_ERROR);
+        }
+    }
+}
+
+/*
+ *  ======== releaseBlockStream ========
+ *  Buffers go back in the order they were handed out.
+ */
+static void releaseBlockStream(I2CSlave_Handle handle, void *block)
+{
+    uintptr_t                      key;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    key = Hwi_disable();
+    if (object->streamTaken &&
+        block == object->streamBufs[object->streamHead]) {
+        object->streamHead = (object->streamHead + 1) % object->streamBufCount;
+        object->streamTaken--;
+    }
+    Hwi_restore(key);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_PACKET
+/*
+ *  ======== readIsrPacket ========
+ *  Function that is called by the ISR in packet mode. The header is kept
+ *  aside until the length field is in; the whole packet then gets its room
+ *  in the ring at once, so a packet is either stored completely or dropped.
+ *  The reader is woken once the last byte of a packet has arrived.
+ */
+static bool readIsrPacket(I2CSlave_Handle handle, unsigned char data)
+{
+    size_t                         i;
+    size_t                         headerSize;
+    size_t                         length;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    /* NACKed bytes of a rejected packet */
+    if (object->state.pktReject) {
+        return (false);
+    }
+
+    headerSize = object->pktLenOffset + object->pktLenSize;
+
+    if (object->state.pktDrop) {
+        STATS_ADD(object, rxOverruns, 1);
+        if (++object->pktPos == object->pktSize) {
+            object->state.pktDrop = false;
+            object->pktPos = 0;
+        }
+        return (false);
+    }
+
+    if (object->pktPos < headerSize) {
+        object->pktHeader[object->pktPos++] = data;
+        if (object->pktPos < headerSize) {
+            return (true);
+        }
+
+        length = 0;
+        for (i = object->pktLenOffset; i < headerSize; i++) {
+            length = (length << 8) | object->pktHeader[i];
+        }
+        object->pktSize = headerSize + length;
+
+        if (object->pktSize > object->pktMaxSize) {
+            /* Tell the master to stop; the ACK override ends with the frame */
+            Log_print1(Diags_USER1, "SLV: packet too large %d",
+                object->pktSize);
+            I2CSlaveACKValueSet(hwAttrs->baseAddr, false);
+            I2CSlaveACKOverride(hwAttrs->baseAddr, true);
+            object->state.pktReject = true;
+            STATS_ADD(object, rxRejected, 1);
+            return (false);
+        }
+
+        if (object->packetCount == I2CTIVASLAVE_PACKET_DEPTH ||
+            hwAttrs->ringBufSize - RingBuf_getCount(&object->ringBuffer) <
+                object->pktSize) {
+            Log_print1(Diags_USER1, "SLV: packet drop %d", object->pktSize);
+            STATS_ADD(object, rxOverruns, headerSize);
+            if (object->pktPos == object->pktSize) {
+                object->pktPos = 0;
+            }
+            else {
+                object->state.pktDrop = true;
+            }
+            return (false);
+        }
+
+        for (i = 0; i < headerSize; i++) {
+            putRing(handle, object->pktHeader[i]);
+        }
+    }
+    else {
+        putRing(handle, data);
+        object->pktPos++;
+    }
+
+    if (object->pktPos == object->pktSize) {
+        object->packets[(object->packetHead + object->packetCount) %
+            I2CTIVASLAVE_PACKET_DEPTH].size = object->pktSize;
+        object->packets[(object->packetHead + object->packetCount) %
+            I2CTIVASLAVE_PACKET_DEPTH].complete = true;
+        object->packetCount++;
+        object->pktPos = 0;
+        READ_CALLBACK(object)(handle, NULL, 0);
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== endIsrPacket ========
+ *  A packet must be sent within one master write. A packet cut short by the
+ *  end of the frame is marked so the reader skips its bytes in the ring.
+ */
+static void endIsrPacket(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    if (object->state.pktReject) {
+        I2CSlaveACKOverride(hwAttrs->baseAddr, false);
+    }
+    else if (object->pktPos && !object->state.pktDrop) {
+        Log_print1(Diags_USER1, "SLV: packet cut %d", object->pktPos);
+        STATS_ADD(object, rxRejected, 1);
+
+        /* Header bytes are in the ring once the length field was in */
+        if (object->pktPos >= object->pktLenOffset + object->pktLenSize) {
+            object->packets[(object->packetHead + object->packetCount) %
+                I2CTIVASLAVE_PACKET_DEPTH].size = object->pktPos;
+            object->packets[(object->packetHead + object->packetCount) %
+                I2CTIVASLAVE_PACKET_DEPTH].complete = false;
+            object->packetCount++;
+        }
+    }
+
+    object->pktPos = 0;
+    object->state.pktDrop = false;
+    object->state.pktReject = false;
+}
+#endif
+
+/*
+ *  ======== readSemCallback ========
+ *  Simple callback to post a semaphore for the blocking mode.
+ */
+static void readSemCallback(I2CSlave_Handle handle, void *buffer, size_t count)
+{
+    I2CTivaSlave_Object *object = handle->object;
+
+    Semaphore_post(Semaphore_handle(&object->readSem));
+}
+
+/*
+ *  ======== readTaskBlocking ========
+ */
+static int readTaskBlocking(I2CSlave_Handle handle)
+{
+    unsigned char                  readIn;
+    uintptr_t                      key;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    uint32_t                       startSeq;
+#endif
+    I2CTivaSlave_Object           *object = handle->object;
+    unsigned char                 *buffer = object->readBuf;
+
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
+    object->state.bufTimeout = false;
+#endif
+    /*
+     * It is possible for the object->timeoutClk and the callback function to
+     * have posted the object->readSem Semaphore from the previous I2CSlave_read
+     * call (if the code below didn't get to stop the clock object in time).
+     * To clear this, we simply do a NO_WAIT pend on (binary) object->readSem
+     * so that it resets the Semaphore count.
+     */
+    Semaphore_pend(Semaphore_handle(&object->readSem), BIOS_NO_WAIT);
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
+    if (object->readTimeout != 0) {
+        Clock_start(Clock_handle(&object->timeoutClk));
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    startSeq = object->readSeq;
+#endif
+
+    while (object->readCount) {
+        key = Hwi_disable();
+
+        if (RingBuf_get(&object->ringBuffer, &readIn) < 0) {
+            Log_print1(Diags_USER1, "SLV: read wait task %d", 1);
+            object->state.callCallback = true;
+            Hwi_restore(key);
+
+            if (object->readTimeout == 0) {
+                break;
+            }
+
+            Semaphore_pend(Semaphore_handle(&object->readSem),
+                BIOS_WAIT_FOREVER);
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
+            if (object->state.bufTimeout == true) {
+                Log_print1(Diags_USER1, "SLV: read tou %d", 1);
+                /* Prevent accidental post in isr */
+                key = Hwi_disable();
+                object->state.callCallback = false;
+                Hwi_restore(key);
+                break;
+            }
+#endif
+            RingBuf_get(&object->ringBuffer, &readIn);
+        }
+        else {
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+            releaseHeld(handle);
+#endif
+            Hwi_restore(key);
+        }
+
+        Log_print1(Diags_USER1, "SLV: read in task 0x%x", readIn);
+
+        *buffer = readIn;
+        buffer++;
+        /* In blocking mode, readCount doesn't not need a lock */
+        object->readCount--;
+    }
+
+    Log_print1(Diags_USER1, "SLV: read finish %d", 1);
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
+    Clock_stop(Clock_handle(&object->timeoutClk));
+#endif
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    object->readSeq += object->readSize - object->readCount;
+    if (object->timestampFxn != NULL && object->readSeq != startSeq) {
+        updateReadStamp(handle, startSeq);
+    }
+#endif
+
+    return (object->readSize - object->readCount);
+}
+
+#if I2CTIVASLAVE_USE_POOL
+/*
+ *  ======== readTaskPool ========
+ *  I2CSlave_read() in pool mode copies the next block and releases it.
+ */
+static int readTaskPool(I2CSlave_Handle handle)
+{
+    int                            count;
+    int                            i;
+    void                          *block;
+    unsigned char                 *data;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    count = readBlockPool(handle, &block);
+    if (count < 0) {
+        return (count);
+    }
+
+    if ((size_t)count > object->readSize) {
+        count = object->readSize;
+    }
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    object->readStamp = poolBlockOf(handle, block)->timestamp;
+    object->state.stampLost = false;
+#endif
+
+    data = block;
+    for (i = 0; i < count; i++) {
+        object->readBuf[i] = data[i];
+    }
+    object->readCount = 0;
+
+    releaseBlockPool(handle, block);
+
+    return (count);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_STREAM
+/*
+ *  ======== readTaskStream ========
+ *  I2CSlave_read() in stream mode copies the next full buffer and releases
+ *  it.
+ */
+static int readTaskStream(I2CSlave_Handle handle)
+{
+    int                            count;
+    void                          *block;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    count = readBlockStream(handle, &block);
+    if (count < 0) {
+        return (count);
+    }
+
+    if ((size_t)count > object->readSize) {
+        count = object->readSize;
+    }
+    memcpy(object->readBuf, block, count);
+    object->readCount = 0;
+
+    releaseBlockStream(handle, block);
+
+    return (count);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_PACKET
+/*
+ *  ======== readTaskPacket ========
+ *  I2CSlave_read() in packet mode copies the next complete packet. Bytes
+ *  that do not fit in the read buffer are discarded with the packet.
+ */
+static int readTaskPacket(I2CSlave_Handle handle)
+{
+    uintptr_t                      key;
+    size_t                         i;
+    size_t                         count;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    uint32_t                       startSeq;
+#endif
+    unsigned char                  readIn;
+    I2CTivaSlave_Packet            packet;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    /* As in readBlockPool(), readSem may be left over from a packet read */
+    while (true) {
+        key = Hwi_disable();
+        if (!object->packetCount) {
+            Hwi_restore(key);
+
+            if (!Semaphore_pend(Semaphore_handle(&object->readSem),
+                    object->readTimeout)) {
+                Log_print1(Diags_USER1, "SLV: packet tou %d", 1);
+                return (I2CSLAVE_ERROR);
+            }
+            continue;
+        }
+
+        /* Take the oldest packet; its bytes stay in the ring until copied */
+        packet = object->packets[object->packetHead];
+        object->packetHead = (object->packetHead + 1) %
+            I2CTIVASLAVE_PACKET_DEPTH;
+        object->packetCount--;
+        Hwi_restore(key);
+
+        /*
+         * Only the task takes bytes out of the ring, so they are copied one
+         * per locked section, as in readTaskBlocking(), and the ISR is not
+         * held off for a whole packet. What was stored of a packet cut short
+         * is skipped.
+         */
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+        startSeq = object->readSeq;
+#endif
+        count = 0;
+        for (i = 0; i < packet.size; i++) {
+            key = Hwi_disable();
+            RingBuf_get(&object->ringBuffer, &readIn);
+            Hwi_restore(key);
+
+            if (packet.complete && count < object->readSize) {
+                object->readBuf[count++] = readIn;
+            }
+        }
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+        object->readSeq += packet.size;
+#endif
+
+        if (packet.complete) {
+            object->readCount = object->readSize - count;
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+            if (object->timestampFxn != NULL) {
+                updateReadStamp(handle, startSeq);
+            }
+#endif
+
+            return (count);
+        }
+    }
+}
+#endif
+
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+/*
+ *  ======== receiveBurst ========
+ *  Takes every byte out of the receive FIFO. The FIFO does not mark the
+ *  first byte of a master write: the START taken before it does, which the
+ *  ISR sees before the address and first byte of the next write are in.
+ *  Called from the ISR or with interrupts disabled.
+ */
+static void receiveBurst(I2CSlave_Handle handle)
+{
+    uint8_t                        readIn;
+    uint32_t                       count = 0;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    while (I2CFIFODataGetNonBlocking(hwAttrs->baseAddr, &readIn)) {
+        receiveByte(handle, I2C_SLAVE_ACT_RREQ |
+            (object->state.rxFirst ? I2C_SCSR_FBR : 0), readIn);
+        object->state.rxFirst = false;
+        count++;
+    }
+
+    if (count) {
+        Log_print1(Diags_USER1, "SLV: rx burst %d", count);
+        STATS_ADD(object, rxBursts, 1);
+    }
+}
+#endif
+
+/*
+ *  ======== receiveByte ========
+ *  Passes a received byte to the command table, a transact in progress or
+ *  the read mode. i2cstatus tells whether it is the first of a master
+ *  write. Called from the ISR or with interrupts disabled.
+ */
+static void receiveByte(I2CSlave_Handle handle, uint32_t i2cstatus,
+                        unsigned char readIn)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+    /* Only the frame-based features look at the first byte flag */
+    (void)i2cstatus;
+
+    STATS_ADD(object, rxBytes, 1);
+    object->state.rxFrame = true;
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    if ((i2cstatus & I2C_SCSR_FBR) && object->timestampFxn != NULL) {
+        object->frameStamp = object->timestampFxn();
+        object->state.stampPending = true;
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+    /* A new master write replaces the command a staged reply was for */
+    if (i2cstatus & I2C_SCSR_FBR) {
+        dropIsrReply(handle);
+    }
+#endif
+
+#if I2CTIVASLAVE_USE_CMD_TABLE
+    if (dispatchCmd(handle, i2cstatus, readIn)) {
+        return;
+    }
+#endif
+#if I2CTIVASLAVE_USE_TRANSACT
+    if (transactIsr(handle, readIn)) {
+        return;
+    }
+#endif
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    if (cacheReceive(handle, readIn)) {
+        return;
+    }
+#endif
+    deliverData(handle, readIn);
 }
 
 /*
- *  ======== readBlockingTimeout ========
+ *  ======== receiveData ========
+ *  Takes the received byte out of the data register, which releases SCL.
+ *  Called from the ISR or with interrupts disabled.
  */
-static Void readBlockingTimeout(UArg arg)
+static void receiveData(I2CSlave_Handle handle, uint32_t i2cstatus)
 {
-    I2CTivaSlave_Object *object = ((I2CSlave_Handle)arg)->object;
-    object->state.bufTimeout = true;
-    Semaphore_post(Semaphore_handle(&object->readSem));
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    receiveByte(handle, i2cstatus, I2CSlaveDataGet(hwAttrs->baseAddr));
 }
 
+#if I2CTIVASLAVE_USE_WATCHDOG
 /*
- *  ======== writePendingTimeout ========
+ *  ======== recoverBus ========
+ *  Resets the slave, which releases SCL and SDA, and brings the driver back
+ *  to idle without closing the instance: a write being read is ended, the
+ *  open frame is closed and a partial command is forgotten. Data already
+ *  received is kept. Called with interrupts disabled.
  */
-static Void writePendingTimeoutCallback(UArg arg)
+static void recoverBus(I2CSlave_Handle handle)
 {
-    I2CTivaSlave_Object *object = ((I2CSlave_Handle)arg)->object;
-    I2CTivaSlave_HWAttrs const    *hwAttrs = ((I2CSlave_Handle)arg)->hwAttrs;
+    uint32_t                       stuckTicks;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
 
-    if (I2CSlaveStatus(hwAttrs->baseAddr) & I2C_SLAVE_ACT_TREQ) {
-        Log_print1(Diags_USER1, "SLV: reset write %d", 1);
+    stuckTicks = Clock_getTicks() - object->activityTick;
+    Log_print1(Diags_USER1, "SLV: bus reset %d", stuckTicks);
 
-        I2CSlaveDataPut(hwAttrs->baseAddr, 0);
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+    /* The reset empties the receive FIFO */
+    if (object->state.highSpeed) {
+        receiveBurst(handle);
     }
+#endif
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /* And the transmit FIFO; the reply is queued again at the next START */
+    unstageData(handle);
+#endif
+
+    I2CSlaveIntDisableEx(hwAttrs->baseAddr,
+        I2C_SLAVE_INT_DATA | I2C_SLAVE_INT_START | I2C_SLAVE_INT_STOP);
+    I2CSlaveDisable(hwAttrs->baseAddr);
+#if !defined(CCWARE)
+    if (hwAttrs->periph) {
+        SysCtlPeripheralReset(hwAttrs->periph);
+    }
+#endif
 
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
     Clock_stop(Clock_handle(&object->writeTimeoutClk));
+#else
+    object->state.txPending = false;
+#endif
+    if (object->state.txActive) {
+        endWrite(handle);
+    }
+
+    if (object->state.frameOpen) {
+        endReadFrame(handle);
+    }
+    object->state.frameOpen = false;
+    object->state.rxFrame = false;
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    if (object->bcastFill != NULL) {
+        bcastEndFrame(handle);
+    }
+#endif
+#if I2CTIVASLAVE_USE_CMD_TABLE
+    object->cmd = NULL;
+#endif
+#if I2CTIVASLAVE_USE_TRANSACT
+    object->xactCount = 0;
+#endif
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    if (object->cacheLifetime) {
+        cacheFlush(handle);
+    }
+#endif
+
+    initHw(handle);
+
+    object->state.busReset = true;
+    STATS_ADD(object, busRecoveries, 1);
+#if I2CTIVASLAVE_USE_STATS
+    object->stats.busRecoveryLast = stuckTicks;
+    if (stuckTicks > object->stats.busRecoveryMax) {
+        object->stats.busRecoveryMax = stuckTicks;
+    }
+#else
+    (void)stuckTicks;
+#endif
 }
+#endif
 
+#if I2CTIVASLAVE_USE_BACKPRESSURE
 /*
- *  ======== readIsrBinaryBlocking ========
- *  Function that is called by the ISR
+ *  ======== releaseHeld ========
+ *  Receives the byte held by the backpressure mode once the ring has room,
+ *  and unmasks the data interrupt. Called with interrupts disabled.
  */
-static bool readIsrBinaryBlocking(I2CSlave_Handle handle)
+static void releaseHeld(I2CSlave_Handle handle)
 {
     I2CTivaSlave_Object           *object = handle->object;
     I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
-    uint32_t                       readIn;
 
-    readIn = I2CSlaveDataGet(hwAttrs->baseAddr);
+    if (!object->state.rxHeld) {
+        return;
+    }
 
-    Log_print1(Diags_USER1, "SLV: read in isr 0x%x", readIn);
+    Log_print1(Diags_USER1, "SLV: release rx %d", 1);
+    object->state.rxHeld = false;
+    receiveData(handle, object->heldStatus);
+    I2CSlaveIntEnableEx(hwAttrs->baseAddr, I2C_SLAVE_INT_DATA);
+}
+#endif
 
-    if (RingBuf_put(&object->ringBuffer, (unsigned char)readIn) == -1) {
-        Log_print1(Diags_USER1, "SLV: ring full %d", 1);
-        return (false);
+/*
+ *  ======== resumeWrite ========
+ *  Answers a master read that is stretched waiting for I2CSlave_write(),
+ *  once the task has put the reply in place.
+ */
+static void resumeWrite(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
+
+    if (I2CSlaveStatus(hwAttrs->baseAddr) & I2C_SLAVE_ACT_TREQ) {
+        /* Stop clock if Write is pending */
+        if (Clock_isActive(Clock_handle(&object->writeTimeoutClk))) {
+            Clock_stop(Clock_handle(&object->writeTimeoutClk));
+            Log_print1(Diags_USER1, "SLV: pendw %d", 1);
+            writeData(handle);
+        }
     }
+#else
+    unsigned int                   key;
 
-    if (object->state.callCallback) {
-        object->state.callCallback = false;
-        object->readCallback(handle, NULL, 0);
+    key = Hwi_disable();
+    if (object->state.txPending &&
+        (I2CSlaveStatus(hwAttrs->baseAddr) & I2C_SLAVE_ACT_TREQ)) {
+        object->state.txPending = false;
+        Log_print1(Diags_USER1, "SLV: pendw %d", 1);
+        writeData(handle);
     }
+    Hwi_restore(key);
+#endif
+}
 
-    return (true);
+#if I2CTIVASLAVE_USE_CMD_TABLE
+/*
+ *  ======== runCmd ========
+ *  Calls the handler of a completely received command and stages its
+ *  response for the next master read, unless the task already owns the
+ *  transmit path.
+ */
+static void runCmd(I2CSlave_Handle handle)
+{
+    size_t                         replySize;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    replySize = object->cmd->cmdFxn(handle, object->cmdBuf, object->cmdSize,
+        object->replyBuf, sizeof(object->replyBuf));
+    object->cmd = NULL;
+
+    if (replySize > sizeof(object->replyBuf)) {
+        replySize = sizeof(object->replyBuf);
+    }
+
+    if (!replySize || object->state.writeActive || object->writeCount) {
+        Log_print1(Diags_USER1, "SLV: cmd no reply %d", replySize);
+        return;
+    }
+
+    object->writeBuf = object->replyBuf;
+    object->writeSize = replySize;
+    object->writeCount = replySize;
+    object->state.isrReply = true;
 }
+#endif
 
+#if I2CTIVASLAVE_USE_TRANSACT
 /*
- *  ======== readSemCallback ========
- *  Simple callback to post a semaphore for the blocking mode.
+ *  ======== runTransact ========
+ *  The I2CSlave_transact() command is complete: build the reply and stage
+ *  it for the next master read. Called from the ISR or with interrupts
+ *  disabled.
  */
-static void readSemCallback(I2CSlave_Handle handle, void *buffer, size_t count)
+static void runTransact(I2CSlave_Handle handle)
 {
-    I2CTivaSlave_Object *object = handle->object;
+    size_t                         replySize;
+    I2CTivaSlave_Object           *object = handle->object;
 
-    Semaphore_post(Semaphore_handle(&object->readSem));
+    replySize = object->xactFxn(handle, object->xactBuf, object->xactSize,
+        object->replyBuf, sizeof(object->replyBuf));
+    object->xactBuf = NULL;
+
+    if (replySize > sizeof(object->replyBuf)) {
+        replySize = sizeof(object->replyBuf);
+    }
+
+    object->writeBuf = object->replyBuf;
+    object->writeSize = replySize;
+    object->writeCount = replySize;
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+    object->state.isrReply = false;
+#endif
+
+    if (!replySize) {
+        WRITE_CALLBACK(object)(handle, (void *)object->writeBuf, 0);
+    }
 }
+#endif
 
+#if I2CTIVASLAVE_USE_SINKS
 /*
- *  ======== readTaskBlocking ========
+ *  ======== sinkDeliver ========
+ *  Hands what the sink stages left of a batch to the read mode, then the
+ *  end of the master write if it was the last batch. Called from the ISR or
+ *  with interrupts disabled.
  */
-static int readTaskBlocking(I2CSlave_Handle handle)
+static void sinkDeliver(I2CSlave_Handle handle, I2CTivaSlave_SinkBatch *batch)
 {
-    unsigned char                  readIn;
-    uintptr_t                      key;
+    size_t                         i;
     I2CTivaSlave_Object           *object = handle->object;
-    unsigned char                 *buffer = object->readBuf;
 
-    object->state.bufTimeout = false;
+    for (i = 0; i < batch->count; i++) {
+        object->readFxns->readIsrFxn(handle, batch->data[i]);
+    }
+    if (batch->end && object->readFxns->endIsrFxn != NULL) {
+        object->readFxns->endIsrFxn(handle);
+    }
+
+    batch->count = 0;
+    batch->end = false;
+}
+
+/*
+ *  ======== sinkFlush ========
+ *  Runs the ISR stages on the batch being filled. Without Swi stages what
+ *  is left goes to the read mode at once, else the batch is queued for the
+ *  Swi and the next one is filled. end marks the last batch of a master
+ *  write. Called from the ISR.
+ */
+static void sinkFlush(I2CSlave_Handle handle, bool end)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_SinkBatch        *batch;
+
+    batch = &object->sinkBatches[(object->sinkHead + object->sinkReady) %
+        (I2CTIVASLAVE_SINK_DEPTH + 1)];
+    if (end) {
+        object->state.sinkFrame = false;
+    }
+
     /*
-     * It is possible for the object->timeoutClk and the callback function to
-     * have posted the object->readSem Semaphore from the previous I2CSlave_read
-     * call (if the code below didn't get to stop the clock object in time).
-     * To clear this, we simply do a NO_WAIT pend on (binary) object->readSem
-     * so that it resets the Semaphore count.
+     * Every batch waits for the Swi: the bytes are dropped, the end goes
+     * with the newest batch, which the Swi is not working on.
      */
-    Semaphore_pend(Semaphore_handle(&object->readSem), BIOS_NO_WAIT);
-    if (object->readTimeout != 0) {
-        Clock_start(Clock_handle(&object->timeoutClk));
+    if (object->sinkReady == I2CTIVASLAVE_SINK_DEPTH) {
+        Log_print1(Diags_USER1, "SLV: sink overrun %d", batch->count);
+        STATS_ADD(object, rxOverruns, batch->count);
+        batch->count = 0;
+        if (end) {
+            object->sinkBatches[(object->sinkHead +
+                I2CTIVASLAVE_SINK_DEPTH - 1) %
+                (I2CTIVASLAVE_SINK_DEPTH + 1)].end = true;
+        }
+        return;
     }
 
-    while (object->readCount) {
-        key = Hwi_disable();
+    batch->end = end;
+    sinkRun(handle, 0, object->sinkIsrCount, batch);
+    STATS_ADD(object, sinkBatches, 1);
 
-        if (RingBuf_get(&object->ringBuffer, &readIn) < 0) {
-            Log_print1(Diags_USER1, "SLV: read wait task %d", 1);
-            object->state.callCallback = true;
-            Hwi_restore(key);
+    if (object->sinkIsrCount == object->sinkCount) {
+        sinkDeliver(handle, batch);
+    }
+    else {
+        object->sinkReady++;
+        Swi_post(Swi_handle(&object->sinkSwi));
+    }
+}
 
-            if (object->readTimeout == 0) {
-                break;
-            }
+/*
+ *  ======== sinkReceive ========
+ *  Adds a received byte to the batch being filled, which goes through the
+ *  ISR stages once it is full.
+ */
+static void sinkReceive(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_SinkBatch        *batch;
 
-            Semaphore_pend(Semaphore_handle(&object->readSem),
-                BIOS_WAIT_FOREVER);
-            if (object->state.bufTimeout == true) {
-                Log_print1(Diags_USER1, "SLV: read tou %d", 1);
-                /* Prevent accidental post in isr */
-                key = Hwi_disable();
-                object->state.callCallback = false;
-                Hwi_restore(key);
-                break;
-            }
-            RingBuf_get(&object->ringBuffer, &readIn);
-        }
-        else {
-            Hwi_restore(key);
+    batch = &object->sinkBatches[(object->sinkHead + object->sinkReady) %
+        (I2CTIVASLAVE_SINK_DEPTH + 1)];
+    batch->data[batch->count++] = data;
+    object->state.sinkFrame = true;
+
+    if (batch->count == I2CTIVASLAVE_SINK_BATCH) {
+        sinkFlush(handle, false);
+    }
+}
+
+/*
+ *  ======== sinkRun ========
+ *  Passes a batch through the stages first up to last. A stage that
+ *  consumed everything ends the batch, unless the master write ends with it.
+ */
+static void sinkRun(I2CSlave_Handle handle, size_t first, size_t last,
+                    I2CTivaSlave_SinkBatch *batch)
+{
+    size_t                         i;
+    size_t                         count;
+    I2CTivaSlave_Object           *object = handle->object;
+
+    for (i = first; i < last && (batch->count || batch->end); i++) {
+        count = object->sinks[i].sinkFxn(handle, object->sinks[i].arg,
+            batch->data, batch->count, batch->end);
+        if (count < batch->count) {
+            batch->count = count;
         }
+    }
+}
 
-        Log_print1(Diags_USER1, "SLV: read in task 0x%x", readIn);
+/*
+ *  ======== sinkSwiFxn ========
+ *  Runs the Swi stages on the queued batches, oldest first, and hands them
+ *  to the read mode.
+ */
+static Void sinkSwiFxn(UArg arg0, UArg arg1)
+{
+    unsigned int                   key;
+    I2CSlave_Handle                handle = (I2CSlave_Handle)arg0;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_SinkBatch        *batch;
 
-        *buffer = readIn;
-        buffer++;
-        /* In blocking mode, readCount doesn't not need a lock */
-        object->readCount--;
+    (void)arg1;
+
+    while (object->sinkReady) {
+        batch = &object->sinkBatches[object->sinkHead];
+        sinkRun(handle, object->sinkIsrCount, object->sinkCount, batch);
+
+        key = Hwi_disable();
+        sinkDeliver(handle, batch);
+        object->sinkHead = (object->sinkHead + 1) %
+            (I2CTIVASLAVE_SINK_DEPTH + 1);
+        object->sinkReady--;
+        Hwi_restore(key);
+    }
+}
+#endif
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+/*
+ *  ======== stageData ========
+ *  Queues the next byte of the write in the transmit FIFO, so the master
+ *  reads it without a TREQ interrupt round trip. One byte is queued at a
+ *  time, and it stays in writeCount until the master has taken it. Called
+ *  from the ISR or with interrupts disabled.
+ */
+static void stageData(I2CSlave_Handle handle)
+{
+    unsigned char                  data;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    if (!object->txPrestage || object->state.txStaged ||
+        !object->writeCount) {
+        return;
     }
 
-    Log_print1(Diags_USER1, "SLV: read finish %d", 1);
-    Clock_stop(Clock_handle(&object->timeoutClk));
-    return (object->readSize - object->readCount);
+    data = object->writeBuf[object->writeSize - object->writeCount];
+    Log_print1(Diags_USER1, "SLV: stage 0x%x", data);
+    I2CFIFODataPut(hwAttrs->baseAddr, data);
+    object->state.txStaged = true;
+
+    /* Only asked for while a byte is staged, so an empty FIFO is quiet */
+    I2CSlaveIntEnableEx(hwAttrs->baseAddr, I2C_SLAVE_INT_TX_FIFO_REQ);
+}
+
+/*
+ *  ======== takeStaged ========
+ *  Called by the ISR on a transmit FIFO request, START or STOP while a byte
+ *  is staged. Once the FIFO is empty the master has read the byte: the
+ *  next one is staged, or the write is complete.
+ */
+static void takeStaged(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    if (!(I2CFIFOStatus(hwAttrs->baseAddr) & I2C_FIFO_TX_EMPTY)) {
+        return;
+    }
+
+    I2CSlaveIntDisableEx(hwAttrs->baseAddr, I2C_SLAVE_INT_TX_FIFO_REQ);
+    object->state.txStaged = false;
+    object->state.txActive = true;
+    object->writeCount--;
+    STATS_ADD(object, txBytes, 1);
+
+    if (object->writeCount) {
+        stageData(handle);
+    }
+    else {
+        Log_print1(Diags_USER1, "SLV: empty write %d", 1);
+        WRITE_CALLBACK(object)(handle, (void *)object->writeBuf,
+            object->writeSize);
+    }
+}
+
+/*
+ *  ======== unstageData ========
+ *  Empties the transmit FIFO of a staged byte the master has not read. The
+ *  byte is still counted in writeCount. Called from the ISR or with
+ *  interrupts disabled.
+ */
+static void unstageData(I2CSlave_Handle handle)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
+
+    if (!object->state.txStaged) {
+        return;
+    }
+
+    Log_print1(Diags_USER1, "SLV: unstage %d", 1);
+    I2CSlaveIntDisableEx(hwAttrs->baseAddr, I2C_SLAVE_INT_TX_FIFO_REQ);
+    I2CTxFIFOFlush(hwAttrs->baseAddr);
+    object->state.txStaged = false;
+}
+#endif
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+/*
+ *  ======== timestampCycCnt ========
+ */
+static uint32_t timestampCycCnt(void)
+{
+    return (HWREG(DWT_CYCCNT));
+}
+#endif
+
+#if I2CTIVASLAVE_USE_TRANSACT
+/*
+ *  ======== transactIsr ========
+ *  Called by the ISR for every received byte. Returns true if the byte was
+ *  taken by the I2CSlave_transact() in progress.
+ */
+static bool transactIsr(I2CSlave_Handle handle, unsigned char data)
+{
+    I2CTivaSlave_Object           *object = handle->object;
+
+    if (object->xactBuf == NULL) {
+        return (false);
+    }
+
+    object->xactBuf[object->xactCount++] = data;
+    if (object->xactCount == object->xactSize) {
+        runTransact(handle);
+    }
+
+    return (true);
+}
+#endif
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+/*
+ *  ======== updateReadStamp ========
+ *  Sets readStamp to the frame holding byte startSeq, or to 0 if its stamp
+ *  was dropped. Frames that started at or before that byte have been read
+ *  and are removed.
+ */
+static void updateReadStamp(I2CSlave_Handle handle, uint32_t startSeq)
+{
+    uintptr_t                      key;
+    I2CTivaSlave_Object           *object = handle->object;
+    I2CTivaSlave_Stamp            *stamp;
+
+    key = Hwi_disable();
+    while (object->stampCount) {
+        stamp = &object->stamps[object->stampHead];
+        if ((int32_t)(stamp->seq - startSeq) > 0) {
+            break;
+        }
+        object->readStamp = stamp->lost ? 0 : stamp->time;
+        object->state.stampLost = stamp->lost;
+        object->stampHead = (object->stampHead + 1) % I2CTIVASLAVE_STAMP_DEPTH;
+        object->stampCount--;
+    }
+    Hwi_restore(key);
 }
+#endif
 
 /*
  *  ======== writeData ========
@@ -428,22 +3168,43 @@ static void writeData(I2CSlave_Handle handle)
     I2CTivaSlave_HWAttrs const    *hwAttrs = handle->hwAttrs;
     unsigned char                 *writeOffset;
 
+    object->state.txActive = true;
+
+#if I2CTIVASLAVE_USE_PRESTAGE
+    /* The byte goes through the FIFO and is counted once it is taken */
+    if (object->txPrestage && object->writeCount) {
+        stageData(handle);
+        return;
+    }
+#endif
+
     writeOffset = (unsigned char *)object->writeBuf +
         object->writeSize * sizeof(unsigned char);
     if (object->writeCount) {
         Log_print1(Diags_USER1, "SLV: write 0x%x", *(writeOffset - object->writeCount));
         I2CSlaveDataPut(hwAttrs->baseAddr, *(writeOffset - object->writeCount));
         object->writeCount--;
+        STATS_ADD(object, txBytes, 1);
     } else {
         Log_print1(Diags_USER1, "SLV: wait write %d", 1);
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
         if (object->readTimeout != 0) {
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+            if (object->pendPercentile) {
+                Clock_setTimeout(Clock_handle(&object->writeTimeoutClk),
+                    object->writePendTimeout);
+            }
+#endif
             Clock_start(Clock_handle(&object->writeTimeoutClk));
         }
+#else
+        object->state.txPending = true;
+#endif
     }
 
     if (!object->writeCount) {
         Log_print1(Diags_USER1, "SLV: empty write %d", 1);
-        object->writeCallback(handle, (void *)object->writeBuf,
+        WRITE_CALLBACK(object)(handle, (void *)object->writeBuf,
             object->writeSize);
     }
 }
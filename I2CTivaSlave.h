@@ -11,21 +11,166 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "I2CSlave.h"
+#include "I2CTivaSlaveConfig.h"
 #include <ti/drivers/utils/RingBuf.h>
 
 #include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Queue.h>
 #include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Swi.h>
 #define ti_sysbios_family_arm_m3_Hwi__nolocalnames
 #include <ti/sysbios/family/arm/m3/Hwi.h>
 
+/* Maximum opcode plus argument bytes of a dispatched command */
+#define I2CTIVASLAVE_CMD_SIZE       8
+
+/* Size of the buffer a command handler stages its response in */
+#define I2CTIVASLAVE_REPLY_SIZE     16
+
+/* Frames whose arrival time is remembered until they are read */
+#define I2CTIVASLAVE_STAMP_DEPTH    4
+
+/* Largest packet header, up to and including the length field */
+#define I2CTIVASLAVE_PACKET_HEADER  8
+
+/* Packets that can wait in the ring buffer to be read */
+#define I2CTIVASLAVE_PACKET_DEPTH   4
+
+/* General call frames kept until every subscriber has released them */
+#define I2CTIVASLAVE_BCAST_DEPTH    4
+
+/* Largest general call frame, longer ones are cut */
+#define I2CTIVASLAVE_BCAST_SIZE     16
+
+/* Received bytes handed to the sink stages at a time */
+#define I2CTIVASLAVE_SINK_BATCH     16
+
+/* Batches that can wait for the Swi sink stages, one more is being filled */
+#define I2CTIVASLAVE_SINK_DEPTH     4
+
+/*
+ *  Receive FIFO level that interrupts in High-speed mode. The rest of the
+ *  8 byte FIFO is the time the ISR has before SCL is held.
+ */
+#define I2CTIVASLAVE_RX_FIFO_TRIGGER I2C_FIFO_CFG_RX_TRIG_4
+
 /* I2CSlave function table pointer */
 extern const I2CSlave_FxnTable I2CTivaSlave_fxnTable;
 
+/*
+ *  Free-running timer used for frame timestamps. If a board does not provide
+ *  one, the Cortex-M DWT cycle counter is used.
+ */
+typedef uint32_t (*I2CTivaSlave_TimestampFxn)(void);
+
 typedef struct I2CTivaSlave_FxnSet {
-    bool (*readIsrFxn)  (I2CSlave_Handle handle);
-    int  (*readTaskFxn) (I2CSlave_Handle handle);
+    bool (*readIsrFxn)      (I2CSlave_Handle handle, unsigned char data);
+    int  (*readTaskFxn)     (I2CSlave_Handle handle);
+    /* Called by the ISR on START and STOP conditions, may be NULL */
+    void (*endIsrFxn)       (I2CSlave_Handle handle);
+    int  (*readBlockFxn)    (I2CSlave_Handle handle, void **block);
+    void (*releaseBlockFxn) (I2CSlave_Handle handle, void *block);
 } I2CTivaSlave_FxnSet;
 
+/* Receive block of the I2CSLAVE_MODE_POOL read mode */
+typedef struct I2CTivaSlave_PoolBlock {
+    Queue_Elem      elem;           /* Link in the free or ready queue */
+    unsigned char  *data;           /* Block storage in poolBufPtr */
+    size_t          count;          /* Number of bytes received */
+    uint32_t        timestamp;      /* Start of the master write */
+    bool            inUse;          /* Handed out, not released yet */
+} I2CTivaSlave_PoolBlock;
+
+/* Start of a master write and the ring buffer sequence of its first byte */
+typedef struct I2CTivaSlave_Stamp {
+    uint32_t        time;
+    uint32_t        seq;
+    bool            lost;           /* Writes from seq on have no known time */
+} I2CTivaSlave_Stamp;
+
+/* Reply remembered for a master write, see replyCacheLifetime */
+typedef struct I2CTivaSlave_CacheEntry {
+    uint32_t        tick;           /* When the reply was written */
+    unsigned char   cmdSize;        /* Bytes in cmd, 0 for a free entry */
+    unsigned char   replySize;      /* Bytes in reply */
+    unsigned char   cmd[I2CTIVASLAVE_CMD_SIZE];
+    unsigned char   reply[I2CTIVASLAVE_REPLY_SIZE];
+} I2CTivaSlave_CacheEntry;
+
+/* Packet of the I2CSLAVE_MODE_PACKET read mode stored in the ring buffer */
+typedef struct I2CTivaSlave_Packet {
+    size_t          size;           /* Bytes it takes in the ring */
+    bool            complete;       /* false if the frame ended first */
+} I2CTivaSlave_Packet;
+
+/* General call frame, shared by all the subscribed instances */
+typedef struct I2CTivaSlave_BcastFrame {
+    uint32_t        seq;            /* Number of the frame */
+    unsigned int    refs;           /* Subscribers that did not release it */
+    bool            ready;          /* false while it is being received */
+    size_t          count;          /* Bytes received */
+    unsigned char   data[I2CTIVASLAVE_BCAST_SIZE];
+} I2CTivaSlave_BcastFrame;
+
+/*
+ *  General call frames of every port that points to it, in the order they
+ *  started, and the list of the instances they are handed to.
+ */
+typedef struct I2CTivaSlave_Broadcast {
+    I2CTivaSlave_BcastFrame frames[I2CTIVASLAVE_BCAST_DEPTH];
+    unsigned int    head;           /* Oldest frame in use */
+    unsigned int    count;          /* Frames in use */
+    uint32_t        seq;            /* Number of the next frame */
+    struct I2CTivaSlave_Object *subscribers;
+    unsigned int    subscriberCount;
+} I2CTivaSlave_Broadcast;
+
+/* Received bytes on their way through the sink stages */
+typedef struct I2CTivaSlave_SinkBatch {
+    size_t          count;          /* Bytes in data */
+    bool            end;            /* Last batch of a master write */
+    unsigned char   data[I2CTIVASLAVE_SINK_BATCH];
+} I2CTivaSlave_SinkBatch;
+
+/* Driver statistics, see I2CTivaSlave_getStats() */
+typedef struct I2CTivaSlave_Stats {
+    uint32_t        rxBytes;        /* Bytes received from the master */
+    uint32_t        rxOverruns;     /* Received bytes dropped for lack of room */
+    uint32_t        rxHolds;        /* Bytes held with SCL low for ring space */
+    uint32_t        rxRejected;     /* Packets too large or cut short */
+    uint32_t        txBytes;        /* Bytes loaded for the master to read */
+    uint32_t        txStuffed;      /* 0x00 sent by the write pending timeout */
+    uint32_t        txDiscarded;    /* Written bytes the master did not read */
+    /*
+     * Write pending timeout in use and the number of response times it was
+     * adapted to, see writePendingPercentile.
+     */
+    uint32_t        txPendTimeout;
+    uint32_t        txPendSamples;
+    /*
+     * Resets of the slave by the bus watchdog, and the ticks from the last
+     * bus activity until the reset.
+     */
+    uint32_t        busRecoveries;
+    uint32_t        busRecoveryLast;
+    uint32_t        busRecoveryMax;
+    uint32_t        cacheHits;      /* Master writes answered from the cache */
+    uint32_t        bcastFrames;    /* General call frames received */
+    uint32_t        bcastOverruns;  /* General call bytes dropped for lack of room */
+    uint32_t        sinkBatches;    /* Batches passed through the sink stages */
+    uint32_t        rxBursts;       /* Receive FIFO drains in High-speed mode */
+    uint32_t        stampDrops;     /* Master writes whose start time was lost */
+    /*
+     * Time from the start of a master write until I2CSlave_read() returned
+     * its data, in timestamp timer counts. Only with frameTimestamps.
+     */
+    uint32_t        latencyCount;
+    uint32_t        latencyLast;
+    uint32_t        latencyMin;
+    uint32_t        latencyMax;
+    uint64_t        latencySum;
+} I2CTivaSlave_Stats;
+
 typedef struct I2CTivaSlave_HWAttrs {
     /* I2CSlave Peripheral's base address */
     unsigned int    baseAddr;
@@ -37,48 +182,300 @@ typedef struct I2CTivaSlave_HWAttrs {
     unsigned char  *ringBufPtr;
     /* Size of ringBufPtr */
     size_t          ringBufSize;
+#if I2CTIVASLAVE_USE_POOL
+    /* Block descriptors for I2CSLAVE_MODE_POOL, NULL if it is not used */
+    I2CTivaSlave_PoolBlock *poolBlocks;
+    /* Storage for poolBlockCount blocks of poolBlockSize bytes */
+    unsigned char  *poolBufPtr;
+    /* Size of a single pool block */
+    size_t          poolBlockSize;
+    /* Number of entries in poolBlocks */
+    unsigned int    poolBlockCount;
+#endif
+    /* Timer for frame timestamps, NULL for the DWT cycle counter */
+    I2CTivaSlave_TimestampFxn timestampFxn;
+    /* SYSCTL_PERIPH_I2Cn reset by the bus watchdog, 0 to only disable it */
+    uint32_t        periph;
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    /* Reply cache entries, NULL if the cache is not used */
+    I2CTivaSlave_CacheEntry *replyCache;
+    /* Number of entries in replyCache */
+    unsigned int    replyCacheCount;
+#endif
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /* General call frames shared by all ports, NULL if not used */
+    I2CTivaSlave_Broadcast *broadcast;
+#endif
 } I2CTivaSlave_HWAttrs;
 
 typedef struct I2CTivaSlave_Object {
     /* I2C Slave state variable */
     struct {
         bool             opened:1;         /* Has the obj been opened */
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
         /*
          * Flag to determine if a timeout has occurred when the user called
          * I2CSlave_read(). This flag is set by the timeoutClk clock object.
          */
         bool             bufTimeout:1;
+#endif
         /*
          * Flag to determine when an ISR needs to perform a callback;
          */
         bool             callCallback:1;
+        /*
+         * Set while I2CSlave_write() owns the transmit path, so a command
+         * handler does not replace the task's data.
+         */
+        bool             writeActive:1;
+#if I2CTIVASLAVE_USE_POOL
+        /*
+         * Set when no pool block was free at the start of a transaction; the
+         * rest of the transaction is dropped.
+         */
+        bool             poolDrop:1;
+#endif
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+        /* frameStamp still has to be queued with the first stored byte */
+        bool             stampPending:1;
+        /* The stamp of the frame last read was dropped; readStamp is 0 */
+        bool             stampLost:1;
+#endif
+        /* The master is reading; its STOP or repeated START ends the write */
+        bool             txActive:1;
+#if I2CTIVASLAVE_USE_PRESTAGE
+        /* The next byte of writeBuf is in the transmit FIFO, not read yet */
+        bool             txStaged:1;
+#endif
+#if I2CTIVASLAVE_USE_CMD_TABLE || I2CTIVASLAVE_USE_REPLY_CACHE
+        /*
+         * writeBuf is a reply the ISR staged for a command or a cache hit,
+         * with no task waiting on it.
+         */
+        bool             isrReply:1;
+#endif
+#if !I2CTIVASLAVE_USE_PEND_TIMEOUT
+        /*
+         * The master is stretched waiting for I2CSlave_write(); only used
+         * without I2CTIVASLAVE_USE_PEND_TIMEOUT, else writeTimeoutClk runs.
+         */
+        bool             txPending:1;
+#endif
+        /* A START was seen and no STOP yet */
+        bool             frameOpen:1;
+        /* The master wrote at least one byte in the open frame */
+        bool             rxFrame:1;
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+        /* A received byte waits in the data register for ring space */
+        bool             rxHeld:1;
+#endif
+#if I2CTIVASLAVE_USE_PACKET
+        /* The packet being received has no room and is dropped */
+        bool             pktDrop:1;
+        /* A packet was too large; the rest of the frame is NACKed */
+        bool             pktReject:1;
+#endif
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+        /* A master write ended at cmdEndTick and was not answered yet */
+        bool             pendSample:1;
+        /* pendEstimate holds a measured response time */
+        bool             pendSeeded:1;
+#endif
+#if I2CTIVASLAVE_USE_WATCHDOG
+        /* The watchdog reset the slave and no interrupt came since */
+        bool             busReset:1;
+#endif
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+        /* The master write so far matches a cache entry and is held back */
+        bool             keyHold:1;
+#endif
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+        /* The slave acknowledges the general call address */
+        bool             generalCall:1;
+        /* In the subscriber list of hwAttrs->broadcast */
+        bool             bcastSubscribed:1;
+#endif
+#if I2CTIVASLAVE_USE_SINKS
+        /* Bytes of the open master write went into the sink stages */
+        bool             sinkFrame:1;
+#endif
+#if I2CTIVASLAVE_USE_HIGH_SPEED
+        /* Received bytes come out of the receive FIFO */
+        bool             highSpeed:1;
+        /* The next byte out of the receive FIFO starts a master write */
+        bool             rxFirst:1;
+#endif
     } state;
 
     unsigned char        slaveAddress;     /* Slave address */
+#if I2CTIVASLAVE_USE_READ_TIMEOUT
     Clock_Struct         timeoutClk;       /* Clock object to for timeouts */
+#endif
     RingBuf_Object       ringBuffer;
 
     /* A complement pair of read functions for both the ISR and I2CSlave_read() */
-    I2CTivaSlave_FxnSet  readFxns;
+    I2CSlave_ReadMode    readMode;         /* Mode for all read calls */
+#if I2CTIVASLAVE_USE_PRESTAGE
+    bool                 txPrestage;       /* Replies go through the TX FIFO */
+#endif
+#if I2CTIVASLAVE_USE_BACKPRESSURE
+    bool                 rxBackpressure;   /* Hold SCL while the ring is full */
+    uint32_t             heldStatus;       /* I2CSlaveStatus() of the held byte */
+#endif
+    const I2CTivaSlave_FxnSet *readFxns;   /* Entry of the read mode */
     unsigned char       *readBuf;          /* Buffer data pointer */
     size_t               readSize;         /* Desired number of bytes to read */
     size_t               readCount;        /* Number of bytes left to read */
     Semaphore_Struct     readSem;          /* I2C read semaphore*/
     unsigned int         readTimeout;      /* Timeout for read semaphore */
+#if I2CTIVASLAVE_USE_CALLBACKS
     I2CSlave_Callback    readCallback;     /* Pointer to read callback */
+#endif
+
+#if I2CTIVASLAVE_USE_POOL
+    Queue_Struct         poolFree;         /* Pool blocks ready to be filled */
+    Queue_Struct         poolReady;        /* Filled blocks for the app */
+    I2CTivaSlave_PoolBlock *poolFill;      /* Block being filled or NULL */
+#endif
+
+#if I2CTIVASLAVE_USE_STREAM
+    /*
+     * Stream mode buffers, in ring order from streamHead: the ones taken by
+     * the app, the full ones waiting, then the one being filled.
+     */
+    void * const        *streamBufs;
+    size_t               streamBufCount;
+    size_t               streamBufSize;
+    size_t               streamHead;       /* Oldest buffer not released */
+    size_t               streamTaken;      /* Buffers held by the app */
+    size_t               streamReady;      /* Full buffers not taken yet */
+    size_t               streamPos;        /* Bytes in the buffer being filled */
+#endif
+
+#if I2CTIVASLAVE_USE_PACKET
+    /* Packet mode header layout and the packet being received */
+    size_t               pktLenOffset;
+    size_t               pktLenSize;
+    size_t               pktMaxSize;
+    size_t               pktPos;           /* Bytes of it received */
+    size_t               pktSize;          /* Full size, once the header is in */
+    unsigned char        pktHeader[I2CTIVASLAVE_PACKET_HEADER];
+    I2CTivaSlave_Packet  packets[I2CTIVASLAVE_PACKET_DEPTH]; /* In the ring */
+    unsigned int         packetHead;       /* Oldest entry in packets */
+    unsigned int         packetCount;      /* Entries in packets */
+#endif
+
+#if I2CTIVASLAVE_USE_TIMESTAMPS
+    I2CTivaSlave_TimestampFxn timestampFxn; /* NULL without frameTimestamps */
+    uint32_t             frameStamp;       /* Start of the current frame */
+    I2CTivaSlave_Stamp   stamps[I2CTIVASLAVE_STAMP_DEPTH]; /* Unread frames */
+    unsigned int         stampHead;        /* Oldest entry in stamps */
+    unsigned int         stampCount;       /* Entries in stamps */
+    uint32_t             rxSeq;            /* Bytes put in the ring buffer */
+    uint32_t             readSeq;          /* Bytes taken from the ring */
+    uint32_t             readStamp;        /* Frame of the last read */
+#endif
 
     const unsigned char *writeBuf;         /* Buffer data pointer */
     size_t               writeSize;        /* Desired number of bytes to write*/
     size_t               writeCount;       /* Number of bytes left to write */
     Semaphore_Struct     writeSem;         /* I2C write semaphore*/
     unsigned int         writeTimeout;     /* Timeout for write semaphore */
+#if I2CTIVASLAVE_USE_PEND_TIMEOUT
     Clock_Struct         writeTimeoutClk;  /* Clock object to for write pending timeouts */
     unsigned int         writePendTimeout; /* Timeout for pending write */
+#endif
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND
+    unsigned int         pendPercentile;   /* 0 if writePendTimeout is fixed */
+    unsigned int         pendMin;          /* Bounds of the adapted timeout */
+    unsigned int         pendMax;
+    uint32_t             pendEstimate;     /* Response time, 1/16 ticks */
+    uint32_t             cmdEndTick;       /* End of the last master write */
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+    /*
+     * Reply cache: the master write being received, and the last one, which
+     * the next I2CSlave_write() answers.
+     */
+    unsigned int         cacheLifetime;    /* 0 if the cache is not used */
+    size_t               keySize;          /* Bytes of the write so far */
+    unsigned char        keyBuf[I2CTIVASLAVE_CMD_SIZE];
+    size_t               lastCmdSize;      /* 0 if answered or too long */
+    unsigned char        lastCmd[I2CTIVASLAVE_CMD_SIZE];
+    unsigned int         cmdPending;       /* Writes the task owes a reply */
+#endif
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+    /*
+     * General call frame being received, and the frames handed to this
+     * instance: those from bcastRelease on were not released, those from
+     * bcastRead on were not read yet.
+     */
+    I2CTivaSlave_BcastFrame *bcastFill;    /* NULL if none */
+    struct I2CTivaSlave_Object *bcastNext; /* Next subscriber */
+    uint32_t             bcastRead;
+    uint32_t             bcastRelease;
+    Semaphore_Struct     bcastSem;         /* Posted for every new frame */
+#endif
+
+#if I2CTIVASLAVE_USE_WATCHDOG
+    Clock_Struct         watchdogClk;      /* Checks for a stuck bus */
+    unsigned int         busWatchdog;      /* Its period, 0 if not used */
+    uint32_t             activityTick;     /* Last slave interrupt */
+#endif
+#if I2CTIVASLAVE_USE_CALLBACKS
     I2CSlave_Callback    writeCallback;    /* Pointer to write callback */
+#endif
+
+#if I2CTIVASLAVE_USE_CMD_TABLE
+    const I2CSlave_Cmd  *cmdTable;         /* Commands answered in the ISR */
+    size_t               cmdCount;         /* Number of entries in cmdTable */
+    const I2CSlave_Cmd  *cmd;              /* Command being received or NULL */
+    size_t               cmdSize;          /* Bytes of cmd received so far */
+    unsigned char        cmdBuf[I2CTIVASLAVE_CMD_SIZE];     /* Opcode + args */
+#endif
+#if I2CTIVASLAVE_USE_REPLY_BUF
+    unsigned char        replyBuf[I2CTIVASLAVE_REPLY_SIZE]; /* Staged reply */
+#endif
+
+#if I2CTIVASLAVE_USE_TRANSACT
+    /* I2CSlave_transact() command in progress, xactBuf is NULL when idle */
+    unsigned char       *xactBuf;
+    size_t               xactSize;
+    size_t               xactCount;
+    I2CSlave_CmdFxn      xactFxn;
+#endif
+
+#if I2CTIVASLAVE_USE_SINKS
+    /*
+     * Sink stages, the first sinkIsrCount of which run in the ISR. The
+     * batch at sinkHead + sinkReady is being filled; the sinkReady before
+     * it wait for the Swi stages.
+     */
+    const I2CSlave_Sink *sinks;
+    size_t               sinkCount;        /* 0 if there are none */
+    size_t               sinkIsrCount;
+    I2CTivaSlave_SinkBatch sinkBatches[I2CTIVASLAVE_SINK_DEPTH + 1];
+    unsigned int         sinkHead;
+    unsigned int         sinkReady;
+    Swi_Struct           sinkSwi;          /* Runs the Swi stages */
+#endif
+
+#if I2CTIVASLAVE_USE_STATS
+    I2CTivaSlave_Stats   stats;            /* Counters since open */
+#endif
 
     ti_sysbios_family_arm_m3_Hwi_Struct hwi;  /* Hwi object handle */
 } I2CTivaSlave_Object, *I2CTivaSlave_Handle;
 
+/*
+ *  Copy the statistics of an opened instance. The counters are reset by
+ *  I2CSlave_open().
+ */
+extern void I2CTivaSlave_getStats(I2CSlave_Handle handle,
+                                  I2CTivaSlave_Stats *stats);
+
 /* Do not interfere with the app if they include the family Hwi module */
 #undef ti_sysbios_family_arm_m3_Hwi__nolocalnames
 
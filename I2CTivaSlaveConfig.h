@@ -0,0 +1,136 @@
+/*
+ * I2CTivaSlaveConfig.h
+ *
+ *  Compile-time features of the I2CTivaSlave driver. Every switch is 1 by
+ *  default, or 0 when I2CTIVASLAVE_MINIMAL is defined, and can be set on
+ *  the compiler command line (-DI2CTIVASLAVE_USE_POOL=0) or in this file.
+ *  A feature that is switched off is removed from I2CTivaSlave_Object and
+ *  from the code; I2CSlave_open() fails when the parameters ask for it, and
+ *  its API calls return I2CSLAVE_ERROR.
+ *
+ *  host/i2csize.sh reports the resulting RAM and flash per instance.
+ */
+
+#ifndef I2CTIVASLAVECONFIG_H_
+#define I2CTIVASLAVECONFIG_H_
+
+#if defined(I2CTIVASLAVE_MINIMAL)
+#define I2CTIVASLAVE_USE_DEFAULT        0
+#else
+#define I2CTIVASLAVE_USE_DEFAULT        1
+#endif
+
+/* I2CSLAVE_MODE_POOL */
+#ifndef I2CTIVASLAVE_USE_POOL
+#define I2CTIVASLAVE_USE_POOL           I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* I2CSLAVE_MODE_STREAM */
+#ifndef I2CTIVASLAVE_USE_STREAM
+#define I2CTIVASLAVE_USE_STREAM         I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* I2CSLAVE_MODE_PACKET */
+#ifndef I2CTIVASLAVE_USE_PACKET
+#define I2CTIVASLAVE_USE_PACKET         I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* frameTimestamps and I2CSlave_readTimestamp() */
+#ifndef I2CTIVASLAVE_USE_TIMESTAMPS
+#define I2CTIVASLAVE_USE_TIMESTAMPS     I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* cmdTable, commands answered in the ISR */
+#ifndef I2CTIVASLAVE_USE_CMD_TABLE
+#define I2CTIVASLAVE_USE_CMD_TABLE      I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* I2CSlave_transact() */
+#ifndef I2CTIVASLAVE_USE_TRANSACT
+#define I2CTIVASLAVE_USE_TRANSACT       I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* txPrestage */
+#ifndef I2CTIVASLAVE_USE_PRESTAGE
+#define I2CTIVASLAVE_USE_PRESTAGE       I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* rxBackpressure */
+#ifndef I2CTIVASLAVE_USE_BACKPRESSURE
+#define I2CTIVASLAVE_USE_BACKPRESSURE   I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/*
+ *  readTimeout in I2CSLAVE_MODE_BLOCKING. Without it readTimeout can only
+ *  be 0 (return what is there) or I2CSLAVE_WAIT_FOREVER.
+ */
+#ifndef I2CTIVASLAVE_USE_READ_TIMEOUT
+#define I2CTIVASLAVE_USE_READ_TIMEOUT   I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/*
+ *  writePendingTimeout. Without it a master read that comes before
+ *  I2CSlave_write() is stretched until the write.
+ */
+#ifndef I2CTIVASLAVE_USE_PEND_TIMEOUT
+#define I2CTIVASLAVE_USE_PEND_TIMEOUT   I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* writePendingPercentile, needs I2CTIVASLAVE_USE_PEND_TIMEOUT */
+#ifndef I2CTIVASLAVE_USE_ADAPTIVE_PEND
+#define I2CTIVASLAVE_USE_ADAPTIVE_PEND  I2CTIVASLAVE_USE_PEND_TIMEOUT
+#endif
+
+/* busWatchdog */
+#ifndef I2CTIVASLAVE_USE_WATCHDOG
+#define I2CTIVASLAVE_USE_WATCHDOG       I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* replyCacheLifetime */
+#ifndef I2CTIVASLAVE_USE_REPLY_CACHE
+#define I2CTIVASLAVE_USE_REPLY_CACHE    I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* generalCall, generalCallSubscribe and I2CSlave_readBroadcast() */
+#ifndef I2CTIVASLAVE_USE_GENERAL_CALL
+#define I2CTIVASLAVE_USE_GENERAL_CALL   I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* sinks, the receive sink stages */
+#ifndef I2CTIVASLAVE_USE_SINKS
+#define I2CTIVASLAVE_USE_SINKS          I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* highSpeed, the receive FIFO burst path */
+#ifndef I2CTIVASLAVE_USE_HIGH_SPEED
+#define I2CTIVASLAVE_USE_HIGH_SPEED     I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/*
+ *  readCallback and writeCallback pointers in the object. Without them the
+ *  driver calls its semaphore callbacks directly.
+ */
+#ifndef I2CTIVASLAVE_USE_CALLBACKS
+#define I2CTIVASLAVE_USE_CALLBACKS      I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* Log_print1() of driver events */
+#ifndef I2CTIVASLAVE_USE_LOG
+#define I2CTIVASLAVE_USE_LOG            I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+/* Counters of I2CTivaSlave_getStats(), which returns zeros without them */
+#ifndef I2CTIVASLAVE_USE_STATS
+#define I2CTIVASLAVE_USE_STATS          I2CTIVASLAVE_USE_DEFAULT
+#endif
+
+#if I2CTIVASLAVE_USE_ADAPTIVE_PEND && !I2CTIVASLAVE_USE_PEND_TIMEOUT
+#error "I2CTIVASLAVE_USE_ADAPTIVE_PEND needs I2CTIVASLAVE_USE_PEND_TIMEOUT"
+#endif
+
+/* The staged reply of a command, a transact or a cache hit */
+#define I2CTIVASLAVE_USE_REPLY_BUF      (I2CTIVASLAVE_USE_CMD_TABLE || \
+                                         I2CTIVASLAVE_USE_TRANSACT || \
+                                         I2CTIVASLAVE_USE_REPLY_CACHE)
+
+#endif /* I2CTIVASLAVECONFIG_H_ */
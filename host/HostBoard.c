@@ -0,0 +1,109 @@
+/*
+ *  ======== HostBoard.c ========
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <inc/hw_ints.h>
+#include <inc/hw_memmap.h>
+#include <driverlib/sysctl.h>
+
+#include "I2CSlave.h"
+#include "I2CTivaSlave.h"
+#include "HostKernel.h"
+#include "HostBoard.h"
+
+I2CTivaSlave_Object i2cTivaSlaveObjects[HostBoard_I2CSLAVECOUNT];
+
+#define HOSTBOARD_I2CSLAVE_RINGBUF(module, ringSize) \
+    unsigned char i2cTivaSlaveRingBuffer##module[ringSize];
+HOSTBOARD_I2CSLAVE_PORTS(HOSTBOARD_I2CSLAVE_RINGBUF)
+#undef HOSTBOARD_I2CSLAVE_RINGBUF
+
+#if I2CTIVASLAVE_USE_POOL
+I2CTivaSlave_PoolBlock i2cTivaSlavePoolBlocks[HostBoard_I2CSLAVECOUNT][4];
+unsigned char i2cTivaSlavePoolBuffer[HostBoard_I2CSLAVECOUNT][4][32];
+#define HOSTBOARD_I2CSLAVE_POOL(module) \
+        .poolBlocks  = i2cTivaSlavePoolBlocks[HostBoard_I2CSLAVE##module], \
+        .poolBufPtr  = i2cTivaSlavePoolBuffer[HostBoard_I2CSLAVE##module][0], \
+        .poolBlockSize  = sizeof(i2cTivaSlavePoolBuffer[0][0]), \
+        .poolBlockCount = sizeof(i2cTivaSlavePoolBlocks[0]) / \
+            sizeof(i2cTivaSlavePoolBlocks[0][0]),
+#else
+#define HOSTBOARD_I2CSLAVE_POOL(module)
+#endif
+
+#if I2CTIVASLAVE_USE_REPLY_CACHE
+I2CTivaSlave_CacheEntry i2cTivaSlaveReplyCache[HostBoard_I2CSLAVECOUNT][4];
+#define HOSTBOARD_I2CSLAVE_REPLYCACHE(module) \
+        .replyCache = i2cTivaSlaveReplyCache[HostBoard_I2CSLAVE##module], \
+        .replyCacheCount = sizeof(i2cTivaSlaveReplyCache[0]) / \
+            sizeof(i2cTivaSlaveReplyCache[0][0]),
+#else
+#define HOSTBOARD_I2CSLAVE_REPLYCACHE(module)
+#endif
+
+#if I2CTIVASLAVE_USE_GENERAL_CALL
+I2CTivaSlave_Broadcast i2cTivaSlaveBroadcast;
+#define HOSTBOARD_I2CSLAVE_BROADCAST \
+        .broadcast = &i2cTivaSlaveBroadcast,
+#else
+#define HOSTBOARD_I2CSLAVE_BROADCAST
+#endif
+
+I2CSlaveSim_Object hostBoardI2CSlaveSims[HostBoard_I2CSLAVECOUNT];
+
+const I2CTivaSlave_HWAttrs i2cTivaSlaveHWAttrs[HostBoard_I2CSLAVECOUNT] = {
+#define HOSTBOARD_I2CSLAVE_HWATTRS(module, ringSize) \
+    { \
+        .baseAddr = I2C##module##_BASE, \
+        .intNum = INT_I2C##module, \
+        .intPriority = (~0), \
+        .ringBufPtr  = i2cTivaSlaveRingBuffer##module, \
+        .ringBufSize = sizeof(i2cTivaSlaveRingBuffer##module), \
+        HOSTBOARD_I2CSLAVE_POOL(module) \
+        .timestampFxn   = HostBoard_timestamp, \
+        .periph = SYSCTL_PERIPH_I2C##module, \
+        HOSTBOARD_I2CSLAVE_REPLYCACHE(module) \
+        HOSTBOARD_I2CSLAVE_BROADCAST \
+    },
+    HOSTBOARD_I2CSLAVE_PORTS(HOSTBOARD_I2CSLAVE_HWATTRS)
+#undef HOSTBOARD_I2CSLAVE_HWATTRS
+};
+
+const I2CSlave_Config I2CSlave_config[] = {
+#define HOSTBOARD_I2CSLAVE_CONFIG(module, ringSize) \
+    { \
+        .fxnTablePtr = &I2CTivaSlave_fxnTable, \
+        .object = &i2cTivaSlaveObjects[HostBoard_I2CSLAVE##module], \
+        .hwAttrs = &i2cTivaSlaveHWAttrs[HostBoard_I2CSLAVE##module] \
+    },
+    HOSTBOARD_I2CSLAVE_PORTS(HOSTBOARD_I2CSLAVE_CONFIG)
+#undef HOSTBOARD_I2CSLAVE_CONFIG
+    {NULL, NULL, NULL}
+};
+
+/*
+ *  ======== HostBoard_timestamp ========
+ */
+uint32_t HostBoard_timestamp(void)
+{
+    return ((uint32_t)(HostKernel_now() * (HOSTBOARD_TIMESTAMP_HZ / 1000000) /
+        1000));
+}
+
+/*
+ *  ======== HostBoard_initI2CSlave ========
+ */
+void HostBoard_initI2CSlave(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < HostBoard_I2CSLAVECOUNT; i++) {
+        I2CSlaveSim_construct(&hostBoardI2CSlaveSims[i],
+            i2cTivaSlaveHWAttrs[i].baseAddr, i2cTivaSlaveHWAttrs[i].intNum);
+    }
+
+    I2CSlave_init();
+}
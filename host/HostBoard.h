@@ -0,0 +1,46 @@
+/*
+ *  ======== HostBoard.h ========
+ *  I2CSlave instances of the host model, in place of EK_TM4C1294XL.c.
+ */
+
+#ifndef HOSTBOARD_H_
+#define HOSTBOARD_H_
+
+#include <stdint.h>
+
+#include "I2CTivaSlave.h"
+#include "I2CSlaveSim.h"
+
+/* Rate of the stand-in frame timestamp timer, like a 120 MHz CYCCNT */
+#define HOSTBOARD_TIMESTAMP_HZ      120000000
+
+/*
+ *  All ten I2C modules, like EK_TM4C1294XL_I2CSLAVE_PORTS with every port
+ *  enabled. I2C5 comes first so HostBoard_I2CSLAVE5 is instance 0, as on
+ *  the board.
+ */
+#define HOSTBOARD_I2CSLAVE_PORTS(PORT) \
+    PORT(5, 32) PORT(0, 32) PORT(1, 32) PORT(2, 32) PORT(3, 32) \
+    PORT(4, 32) PORT(6, 32) PORT(7, 32) PORT(8, 32) PORT(9, 32)
+
+typedef enum HostBoard_I2CSlaveName {
+#define HOSTBOARD_I2CSLAVE_NAME(module, ringSize) \
+    HostBoard_I2CSLAVE##module,
+    HOSTBOARD_I2CSLAVE_PORTS(HOSTBOARD_I2CSLAVE_NAME)
+#undef HOSTBOARD_I2CSLAVE_NAME
+
+    HostBoard_I2CSLAVECOUNT
+} HostBoard_I2CSlaveName;
+
+extern const I2CTivaSlave_HWAttrs i2cTivaSlaveHWAttrs[HostBoard_I2CSLAVECOUNT];
+
+/* Register models of the instances, indexed like I2CSlave_config */
+extern I2CSlaveSim_Object hostBoardI2CSlaveSims[HostBoard_I2CSLAVECOUNT];
+
+/* Frame timestamp timer of the host instances, runs on simulated time */
+extern uint32_t HostBoard_timestamp(void);
+
+/* Construct the register models and call I2CSlave_init() */
+extern void HostBoard_initI2CSlave(void);
+
+#endif /* HOSTBOARD_H_ */
@@ -0,0 +1,562 @@
+/*
+ *  ======== HostKernel.c ========
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Queue.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Swi.h>
+#include <ti/sysbios/family/arm/m3/Hwi.h>
+#include <ti/drivers/utils/RingBuf.h>
+
+#include "HostKernel.h"
+
+#define HOSTKERNEL_NUM_INTS     256
+
+static uint64_t             nowNs;
+static uint64_t             tickNs = 1000000;
+static uint32_t             ticks;
+static Clock_Struct        *clockList;
+static HostKernel_IdleFxn   idleFxn;
+static void                *idleArg;
+static Hwi_Struct          *hwiTable[HOSTKERNEL_NUM_INTS];
+static uint64_t             hwiTimeNs[HOSTKERNEL_NUM_INTS];
+static uint32_t             hwiCount[HOSTKERNEL_NUM_INTS];
+static unsigned int         hwiDepth;
+static bool                 swiActive;
+static Swi_Struct          *swiReady;
+
+/*
+ *  ======== monotonicNs ========
+ */
+static uint64_t monotonicNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+/*
+ *  ======== HostKernel_init ========
+ */
+void HostKernel_init(uint64_t tickPeriodNs)
+{
+    nowNs = 0;
+    ticks = 0;
+    tickNs = tickPeriodNs ? tickPeriodNs : 1000000;
+    clockList = NULL;
+    idleFxn = NULL;
+    idleArg = NULL;
+    memset(hwiTable, 0, sizeof(hwiTable));
+    memset(hwiTimeNs, 0, sizeof(hwiTimeNs));
+    memset(hwiCount, 0, sizeof(hwiCount));
+    hwiDepth = 0;
+    swiActive = false;
+    swiReady = NULL;
+}
+
+/*
+ *  ======== HostKernel_setIdleFxn ========
+ */
+void HostKernel_setIdleFxn(HostKernel_IdleFxn fxn, void *arg)
+{
+    idleFxn = fxn;
+    idleArg = arg;
+}
+
+/*
+ *  ======== HostKernel_now ========
+ */
+uint64_t HostKernel_now(void)
+{
+    return (nowNs);
+}
+
+/*
+ *  ======== tick ========
+ *  Runs every active clock whose deadline is the current tick.
+ */
+static void tick(void)
+{
+    Clock_Struct   *clk;
+
+    ticks++;
+
+    for (clk = clockList; clk != NULL; clk = clk->next) {
+        if (clk->active && clk->deadline == ticks) {
+            if (clk->period) {
+                clk->deadline = ticks + clk->period;
+            }
+            else {
+                clk->active = false;
+            }
+            clk->fxn(clk->arg);
+        }
+    }
+}
+
+/*
+ *  ======== HostKernel_advanceTo ========
+ */
+void HostKernel_advanceTo(uint64_t timeNs)
+{
+    while (timeNs > nowNs) {
+        uint64_t nextTickNs = (uint64_t)(ticks + 1) * tickNs;
+
+        if (timeNs < nextTickNs) {
+            nowNs = timeNs;
+            break;
+        }
+        nowNs = nextTickNs;
+        tick();
+    }
+}
+
+/*
+ *  ======== HostKernel_advance ========
+ */
+void HostKernel_advance(uint64_t ns)
+{
+    HostKernel_advanceTo(nowNs + ns);
+}
+
+/*
+ *  ======== runSwis ========
+ *  Runs the posted Swis in the order they were posted.
+ */
+static void runSwis(void)
+{
+    Swi_Struct     *swi;
+
+    if (swiActive) {
+        return;
+    }
+
+    swiActive = true;
+    while ((swi = swiReady) != NULL) {
+        swiReady = swi->next;
+        swi->posted = false;
+        swi->fxn(swi->arg0, swi->arg1);
+    }
+    swiActive = false;
+}
+
+/*
+ *  ======== HostKernel_raise ========
+ *  Swis posted by the Hwi run after it, and are not counted in its time.
+ */
+bool HostKernel_raise(int intNum)
+{
+    uint64_t        start;
+    Hwi_Struct     *hwi;
+
+    if (intNum < 0 || intNum >= HOSTKERNEL_NUM_INTS ||
+        hwiTable[intNum] == NULL) {
+        return (false);
+    }
+
+    hwi = hwiTable[intNum];
+    hwiDepth++;
+    start = monotonicNs();
+    hwi->fxn(hwi->arg);
+    hwiTimeNs[intNum] += monotonicNs() - start;
+    hwiCount[intNum]++;
+    hwiDepth--;
+
+    if (hwiDepth == 0) {
+        runSwis();
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== HostKernel_hwiTimeNs ========
+ */
+uint64_t HostKernel_hwiTimeNs(int intNum)
+{
+    return (intNum >= 0 && intNum < HOSTKERNEL_NUM_INTS ?
+        hwiTimeNs[intNum] : 0);
+}
+
+/*
+ *  ======== HostKernel_hwiCount ========
+ */
+uint32_t HostKernel_hwiCount(int intNum)
+{
+    return (intNum >= 0 && intNum < HOSTKERNEL_NUM_INTS ?
+        hwiCount[intNum] : 0);
+}
+
+/*
+ *  ======== nextClockDeadline ========
+ *  Returns the tick of the earliest active clock, or 0 if there is none.
+ */
+static uint32_t nextClockDeadline(void)
+{
+    uint32_t        deadline = 0;
+    Clock_Struct   *clk;
+
+    for (clk = clockList; clk != NULL; clk = clk->next) {
+        if (clk->active && (deadline == 0 || clk->deadline < deadline)) {
+            deadline = clk->deadline;
+        }
+    }
+
+    return (deadline);
+}
+
+/*
+ *  ======== Hwi ========
+ */
+void ti_sysbios_family_arm_m3_Hwi_Params_init(Hwi_Params *params)
+{
+    params->arg = 0;
+    params->priority = ~0;
+}
+
+void ti_sysbios_family_arm_m3_Hwi_construct(Hwi_Struct *hwi, int intNum,
+    Hwi_FuncPtr fxn, const Hwi_Params *params, void *eb)
+{
+    hwi->intNum = intNum;
+    hwi->fxn = fxn;
+    hwi->arg = params->arg;
+
+    if (intNum >= 0 && intNum < HOSTKERNEL_NUM_INTS) {
+        hwiTable[intNum] = hwi;
+    }
+}
+
+void ti_sysbios_family_arm_m3_Hwi_destruct(Hwi_Struct *hwi)
+{
+    if (hwi->intNum >= 0 && hwi->intNum < HOSTKERNEL_NUM_INTS &&
+        hwiTable[hwi->intNum] == hwi) {
+        hwiTable[hwi->intNum] = NULL;
+    }
+}
+
+/* Interrupts only run when the host model raises them, so there is no lock */
+unsigned int ti_sysbios_family_arm_m3_Hwi_disable(void)
+{
+    return (0);
+}
+
+void ti_sysbios_family_arm_m3_Hwi_restore(unsigned int key)
+{
+}
+
+/*
+ *  ======== Swi ========
+ */
+void Swi_Params_init(Swi_Params *params)
+{
+    params->arg0 = 0;
+    params->arg1 = 0;
+    params->priority = ~0;
+}
+
+void Swi_construct(Swi_Struct *swi, Swi_FuncPtr fxn, const Swi_Params *params,
+    void *eb)
+{
+    swi->fxn = fxn;
+    swi->arg0 = params->arg0;
+    swi->arg1 = params->arg1;
+    swi->posted = false;
+    swi->next = NULL;
+}
+
+void Swi_destruct(Swi_Struct *swi)
+{
+    Swi_Struct    **link;
+
+    for (link = &swiReady; *link != NULL; link = &(*link)->next) {
+        if (*link == swi) {
+            *link = swi->next;
+            break;
+        }
+    }
+    swi->posted = false;
+}
+
+void Swi_post(Swi_Handle swi)
+{
+    Swi_Struct    **link;
+
+    if (swi->posted) {
+        return;
+    }
+
+    swi->posted = true;
+    swi->next = NULL;
+    for (link = &swiReady; *link != NULL; link = &(*link)->next) {
+    }
+    *link = swi;
+
+    if (hwiDepth == 0) {
+        runSwis();
+    }
+}
+
+/*
+ *  ======== Clock ========
+ */
+void Clock_Params_init(Clock_Params *params)
+{
+    params->period = 0;
+    params->startFlag = FALSE;
+    params->arg = 0;
+}
+
+void Clock_construct(Clock_Struct *clk, Clock_FuncPtr fxn, UInt32 timeout,
+    const Clock_Params *params)
+{
+    clk->fxn = fxn;
+    clk->arg = params->arg;
+    clk->timeout = timeout;
+    clk->period = params->period;
+    clk->active = false;
+    clk->next = clockList;
+    clockList = clk;
+
+    if (params->startFlag) {
+        Clock_start(clk);
+    }
+}
+
+void Clock_destruct(Clock_Struct *clk)
+{
+    Clock_Struct  **link;
+
+    for (link = &clockList; *link != NULL; link = &(*link)->next) {
+        if (*link == clk) {
+            *link = clk->next;
+            break;
+        }
+    }
+}
+
+void Clock_start(Clock_Handle clk)
+{
+    clk->deadline = ticks + (clk->timeout ? clk->timeout : clk->period);
+    clk->active = true;
+}
+
+void Clock_stop(Clock_Handle clk)
+{
+    clk->active = false;
+}
+
+bool Clock_isActive(Clock_Handle clk)
+{
+    return (clk->active);
+}
+
+void Clock_setTimeout(Clock_Handle clk, UInt32 timeout)
+{
+    clk->timeout = timeout;
+}
+
+void Clock_setPeriod(Clock_Handle clk, UInt32 period)
+{
+    clk->period = period;
+}
+
+UInt32 Clock_getTicks(void)
+{
+    return (ticks);
+}
+
+/*
+ *  ======== Semaphore ========
+ */
+void Semaphore_Params_init(Semaphore_Params *params)
+{
+    params->mode = Semaphore_Mode_COUNTING;
+}
+
+void Semaphore_construct(Semaphore_Struct *sem, int count,
+    const Semaphore_Params *params)
+{
+    sem->mode = params ? params->mode : Semaphore_Mode_COUNTING;
+    sem->count = count;
+}
+
+void Semaphore_destruct(Semaphore_Struct *sem)
+{
+}
+
+bool Semaphore_pend(Semaphore_Handle sem, UInt32 timeout)
+{
+    uint32_t    deadline = ticks + timeout;
+    uint32_t    next;
+
+    while (sem->count == 0) {
+        if (timeout == BIOS_NO_WAIT ||
+            (timeout != BIOS_WAIT_FOREVER && ticks >= deadline)) {
+            return (false);
+        }
+
+        if (idleFxn != NULL && idleFxn(idleArg)) {
+            continue;
+        }
+
+        /*
+         * Nothing else will produce bus traffic, only clocks can still post
+         * the semaphore. A task blocked forever with no clock running would
+         * hang, so it gets a timeout instead.
+         */
+        next = nextClockDeadline();
+        if (next != 0 && (timeout == BIOS_WAIT_FOREVER || next <= deadline)) {
+            HostKernel_advanceTo((uint64_t)next * tickNs);
+        }
+        else if (timeout != BIOS_WAIT_FOREVER) {
+            HostKernel_advanceTo((uint64_t)deadline * tickNs);
+        }
+        else {
+            return (false);
+        }
+    }
+
+    if (sem->mode == Semaphore_Mode_BINARY) {
+        sem->count = 0;
+    }
+    else {
+        sem->count--;
+    }
+
+    return (true);
+}
+
+void Semaphore_post(Semaphore_Handle sem)
+{
+    if (sem->mode == Semaphore_Mode_BINARY) {
+        sem->count = 1;
+    }
+    else {
+        sem->count++;
+    }
+}
+
+int Semaphore_getCount(Semaphore_Handle sem)
+{
+    return (sem->count);
+}
+
+/*
+ *  ======== Queue ========
+ */
+void Queue_construct(Queue_Struct *queue, void *params)
+{
+    queue->elem.next = &queue->elem;
+    queue->elem.prev = &queue->elem;
+}
+
+void Queue_destruct(Queue_Struct *queue)
+{
+}
+
+bool Queue_empty(Queue_Handle queue)
+{
+    return (queue->elem.next == &queue->elem);
+}
+
+void *Queue_dequeue(Queue_Handle queue)
+{
+    Queue_Elem *elem = queue->elem.next;
+
+    elem->next->prev = &queue->elem;
+    queue->elem.next = elem->next;
+
+    return (elem);
+}
+
+void Queue_enqueue(Queue_Handle queue, Queue_Elem *elem)
+{
+    elem->next = &queue->elem;
+    elem->prev = queue->elem.prev;
+    queue->elem.prev->next = elem;
+    queue->elem.prev = elem;
+}
+
+void *Queue_get(Queue_Handle queue)
+{
+    return (Queue_dequeue(queue));
+}
+
+void Queue_put(Queue_Handle queue, Queue_Elem *elem)
+{
+    Queue_enqueue(queue, elem);
+}
+
+/*
+ *  ======== RingBuf ========
+ */
+void RingBuf_construct(RingBuf_Handle object, unsigned char *bufferPtr,
+    size_t bufferSize)
+{
+    object->buffer = bufferPtr;
+    object->length = bufferSize;
+    object->count = 0;
+    object->head = bufferSize - 1;
+    object->tail = 0;
+    object->maxCount = 0;
+}
+
+int RingBuf_get(RingBuf_Handle object, unsigned char *data)
+{
+    if (!object->count) {
+        return (-1);
+    }
+
+    *data = object->buffer[object->tail];
+    object->tail = (object->tail + 1) % object->length;
+    object->count--;
+
+    return (object->count);
+}
+
+int RingBuf_getCount(RingBuf_Handle object)
+{
+    return (object->count);
+}
+
+bool RingBuf_isFull(RingBuf_Handle object)
+{
+    return (object->count == object->length);
+}
+
+int RingBuf_getMaxCount(RingBuf_Handle object)
+{
+    return (object->maxCount);
+}
+
+int RingBuf_peek(RingBuf_Handle object, unsigned char *data)
+{
+    *data = object->buffer[object->tail];
+
+    return (object->count);
+}
+
+int RingBuf_put(RingBuf_Handle object, unsigned char data)
+{
+    if (object->count == object->length) {
+        return (-1);
+    }
+
+    object->head = (object->head + 1) % object->length;
+    object->buffer[object->head] = data;
+    object->count++;
+    if (object->count > object->maxCount) {
+        object->maxCount = object->count;
+    }
+
+    return (object->count);
+}
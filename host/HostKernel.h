@@ -0,0 +1,49 @@
+/*
+ *  ======== HostKernel.h ========
+ *  Single threaded stand-in for the SYS/BIOS services used by the I2CSlave
+ *  driver, so the driver can run unmodified on Linux.
+ *
+ *  Simulated time only moves forward through HostKernel_advance(). When the
+ *  application pends on a semaphore that is not available, the idle function
+ *  (normally the replay engine) is called to produce bus traffic until the
+ *  semaphore is posted or the pend times out.
+ */
+
+#ifndef HOSTKERNEL_H_
+#define HOSTKERNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <xdc/std.h>
+
+/*
+ *  Idle function run while a task is blocked. Returns false once it has
+ *  nothing left to do.
+ */
+typedef bool (*HostKernel_IdleFxn)(void *arg);
+
+/* Reset time, clocks and interrupt vectors. tickPeriodNs is one Clock tick */
+extern void     HostKernel_init(uint64_t tickPeriodNs);
+
+extern void     HostKernel_setIdleFxn(HostKernel_IdleFxn fxn, void *arg);
+
+/* Current simulated time in nanoseconds */
+extern uint64_t HostKernel_now(void);
+
+/* Move simulated time to now + ns, running every Clock that expires */
+extern void     HostKernel_advance(uint64_t ns);
+
+/* Move simulated time to an absolute time, if it lies in the future */
+extern void     HostKernel_advanceTo(uint64_t timeNs);
+
+/* Call the Hwi function constructed for intNum. Returns false if none */
+extern bool     HostKernel_raise(int intNum);
+
+/* Host wall-clock time spent in Hwi functions raised for intNum */
+extern uint64_t HostKernel_hwiTimeNs(int intNum);
+
+/* Number of times the Hwi function for intNum was called */
+extern uint32_t HostKernel_hwiCount(int intNum);
+
+#endif /* HOSTKERNEL_H_ */
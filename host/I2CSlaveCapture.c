@@ -0,0 +1,243 @@
+/*
+ *  ======== I2CSlaveCapture.c ========
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "I2CSlaveCapture.h"
+
+static const uint8_t captureMagic[4] = {'I', '2', 'C', 'C'};
+
+/*
+ *  ======== readVarint ========
+ */
+static bool readVarint(I2CSlaveCapture_Reader *reader, uint64_t *value)
+{
+    unsigned int    shift = 0;
+    uint8_t         byte;
+
+    *value = 0;
+    do {
+        if (reader->pos >= reader->size || shift > 63) {
+            return (false);
+        }
+        byte = reader->buf[reader->pos++];
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return (true);
+}
+
+/*
+ *  ======== I2CSlaveCapture_open ========
+ */
+bool I2CSlaveCapture_open(I2CSlaveCapture_Reader *reader, const uint8_t *buf,
+    size_t size)
+{
+    reader->buf = buf;
+    reader->size = size;
+    reader->pos = I2CSLAVECAPTURE_HEADER_SIZE;
+    reader->timeNs = 0;
+    reader->error = false;
+
+    if (size < I2CSLAVECAPTURE_HEADER_SIZE ||
+        memcmp(buf, captureMagic, sizeof(captureMagic)) != 0 ||
+        buf[4] != I2CSLAVECAPTURE_VERSION) {
+        reader->error = true;
+        return (false);
+    }
+
+    reader->bitRate = (uint32_t)buf[8] | (uint32_t)buf[9] << 8 |
+        (uint32_t)buf[10] << 16 | (uint32_t)buf[11] << 24;
+
+    return (reader->bitRate != 0);
+}
+
+/*
+ *  ======== I2CSlaveCapture_next ========
+ */
+bool I2CSlaveCapture_next(I2CSlaveCapture_Reader *reader,
+    I2CSlaveCapture_Record *record)
+{
+    uint64_t        delta;
+    uint8_t         byte;
+
+    if (reader->error || reader->pos >= reader->size) {
+        return (false);
+    }
+
+    record->type = (I2CSlaveCapture_Type)reader->buf[reader->pos++];
+    if (!readVarint(reader, &delta)) {
+        reader->error = true;
+        return (false);
+    }
+    reader->timeNs += delta;
+    record->timeNs = reader->timeNs;
+    record->count = 0;
+    record->data = NULL;
+
+    switch (record->type) {
+        case I2CSLAVECAPTURE_START:
+        case I2CSLAVECAPTURE_STOP:
+            return (true);
+
+        case I2CSLAVECAPTURE_ADDR:
+            if (reader->pos >= reader->size) {
+                break;
+            }
+            byte = reader->buf[reader->pos++];
+            record->address = byte >> 1;
+            record->read = byte & 1;
+            return (true);
+
+        case I2CSLAVECAPTURE_LINES:
+            if (reader->pos >= reader->size) {
+                break;
+            }
+            record->lines = reader->buf[reader->pos++] & 3;
+            return (true);
+
+        case I2CSLAVECAPTURE_DATA:
+            if (reader->pos >= reader->size) {
+                break;
+            }
+            record->count = reader->buf[reader->pos++];
+            if (record->count == 0 ||
+                reader->size - reader->pos < record->count) {
+                break;
+            }
+            record->data = &reader->buf[reader->pos];
+            reader->pos += record->count;
+            return (true);
+
+        default:
+            break;
+    }
+
+    reader->error = true;
+    return (false);
+}
+
+/*
+ *  ======== writeBytes ========
+ */
+static bool writeBytes(I2CSlaveCapture_Writer *writer, const uint8_t *data,
+    size_t count)
+{
+    if (writer->overflow || writer->size - writer->pos < count) {
+        writer->overflow = true;
+        return (false);
+    }
+
+    memcpy(&writer->buf[writer->pos], data, count);
+    writer->pos += count;
+
+    return (true);
+}
+
+/*
+ *  ======== writeRecord ========
+ *  Writes the type and the time delta of a record.
+ */
+static bool writeRecord(I2CSlaveCapture_Writer *writer,
+    I2CSlaveCapture_Type type, uint64_t timeNs)
+{
+    uint8_t         varint[11];
+    size_t          count = 0;
+    uint64_t        delta;
+
+    delta = timeNs > writer->timeNs ? timeNs - writer->timeNs : 0;
+    writer->timeNs += delta;
+
+    varint[count++] = type;
+    do {
+        varint[count] = delta & 0x7F;
+        delta >>= 7;
+        if (delta) {
+            varint[count] |= 0x80;
+        }
+        count++;
+    } while (delta);
+
+    return (writeBytes(writer, varint, count));
+}
+
+/*
+ *  ======== I2CSlaveCapture_writerInit ========
+ */
+bool I2CSlaveCapture_writerInit(I2CSlaveCapture_Writer *writer, uint8_t *buf,
+    size_t size, uint32_t bitRate)
+{
+    uint8_t header[I2CSLAVECAPTURE_HEADER_SIZE] = {
+        'I', '2', 'C', 'C', I2CSLAVECAPTURE_VERSION, 0, 0, 0,
+        bitRate & 0xFF, (bitRate >> 8) & 0xFF, (bitRate >> 16) & 0xFF,
+        (bitRate >> 24) & 0xFF
+    };
+
+    writer->buf = buf;
+    writer->size = size;
+    writer->pos = 0;
+    writer->timeNs = 0;
+    writer->overflow = false;
+
+    return (writeBytes(writer, header, sizeof(header)));
+}
+
+/*
+ *  ======== I2CSlaveCapture_start ========
+ */
+bool I2CSlaveCapture_start(I2CSlaveCapture_Writer *writer, uint64_t timeNs)
+{
+    return (writeRecord(writer, I2CSLAVECAPTURE_START, timeNs));
+}
+
+/*
+ *  ======== I2CSlaveCapture_addr ========
+ */
+bool I2CSlaveCapture_addr(I2CSlaveCapture_Writer *writer, uint64_t timeNs,
+    uint8_t address, bool read)
+{
+    uint8_t byte = (uint8_t)(address << 1) | (read ? 1 : 0);
+
+    return (writeRecord(writer, I2CSLAVECAPTURE_ADDR, timeNs) &&
+        writeBytes(writer, &byte, 1));
+}
+
+/*
+ *  ======== I2CSlaveCapture_data ========
+ */
+bool I2CSlaveCapture_data(I2CSlaveCapture_Writer *writer, uint64_t timeNs,
+    const uint8_t *data, size_t count)
+{
+    uint8_t byte = (uint8_t)count;
+
+    if (count == 0 || count > I2CSLAVECAPTURE_DATA_MAX) {
+        return (false);
+    }
+
+    return (writeRecord(writer, I2CSLAVECAPTURE_DATA, timeNs) &&
+        writeBytes(writer, &byte, 1) && writeBytes(writer, data, count));
+}
+
+/*
+ *  ======== I2CSlaveCapture_stop ========
+ */
+bool I2CSlaveCapture_stop(I2CSlaveCapture_Writer *writer, uint64_t timeNs)
+{
+    return (writeRecord(writer, I2CSLAVECAPTURE_STOP, timeNs));
+}
+
+/*
+ *  ======== I2CSlaveCapture_lines ========
+ */
+bool I2CSlaveCapture_lines(I2CSlaveCapture_Writer *writer, uint64_t timeNs,
+    bool scl, bool sda)
+{
+    uint8_t byte = (scl ? 1 : 0) | (sda ? 2 : 0);
+
+    return (writeRecord(writer, I2CSLAVECAPTURE_LINES, timeNs) &&
+        writeBytes(writer, &byte, 1));
+}
@@ -0,0 +1,105 @@
+/*
+ *  ======== I2CSlaveCapture.h ========
+ *  Compact binary format for I2C bus captures.
+ *
+ *  A capture starts with a 12 byte header:
+ *
+ *      offset  size  field
+ *      0       4     magic "I2CC"
+ *      4       1     format version (I2CSLAVECAPTURE_VERSION)
+ *      5       3     reserved, 0
+ *      8       4     bus bit rate in bit/s, little endian
+ *
+ *  followed by records. Every record starts with its type byte and the time
+ *  since the previous record in nanoseconds, encoded as an unsigned LEB128
+ *  varint (7 bits per byte, least significant group first, bit 7 set on all
+ *  but the last byte). The payload depends on the type:
+ *
+ *      START   none
+ *      ADDR    1 byte: 7-bit address << 1 | R/W (1 = master read)
+ *      DATA    1 byte count (1..255), then count data bytes
+ *      STOP    none
+ *      LINES   1 byte: bit 0 SCL, bit 1 SDA level from then on
+ *
+ *  The timestamp of a DATA record is the start of its first byte; the
+ *  following bytes are assumed back to back at the bus bit rate. In a master
+ *  read, the data bytes are what the captured slave sent.
+ *
+ *  LINES records are for fault injection: a master that disappears in the
+ *  middle of a transaction leaves the lines low and sends no STOP.
+ */
+
+#ifndef I2CSLAVECAPTURE_H_
+#define I2CSLAVECAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define I2CSLAVECAPTURE_VERSION         1
+#define I2CSLAVECAPTURE_HEADER_SIZE     12
+#define I2CSLAVECAPTURE_DATA_MAX        255
+
+typedef enum I2CSlaveCapture_Type {
+    I2CSLAVECAPTURE_START = 1,      /* START or repeated START */
+    I2CSLAVECAPTURE_ADDR  = 2,      /* Address byte with R/W bit */
+    I2CSLAVECAPTURE_DATA  = 3,      /* Data bytes following the address */
+    I2CSLAVECAPTURE_STOP  = 4,      /* STOP */
+    I2CSLAVECAPTURE_LINES = 5       /* SCL and SDA levels */
+} I2CSlaveCapture_Type;
+
+typedef struct I2CSlaveCapture_Record {
+    I2CSlaveCapture_Type type;
+    uint64_t        timeNs;         /* Absolute time of the record */
+    uint8_t         address;        /* ADDR: 7-bit address */
+    bool            read;           /* ADDR: master read */
+    size_t          count;          /* DATA: number of bytes */
+    const uint8_t  *data;           /* DATA: bytes, inside the capture */
+    uint8_t         lines;          /* LINES: bit 0 SCL, bit 1 SDA */
+} I2CSlaveCapture_Record;
+
+typedef struct I2CSlaveCapture_Reader {
+    const uint8_t  *buf;
+    size_t          size;
+    size_t          pos;            /* Offset of the next record */
+    uint64_t        timeNs;         /* Time of the last record */
+    uint32_t        bitRate;        /* From the header */
+    bool            error;          /* A malformed record was found */
+} I2CSlaveCapture_Reader;
+
+typedef struct I2CSlaveCapture_Writer {
+    uint8_t        *buf;
+    size_t          size;
+    size_t          pos;            /* Bytes written so far */
+    uint64_t        timeNs;         /* Time of the last record */
+    bool            overflow;       /* A record did not fit in buf */
+} I2CSlaveCapture_Writer;
+
+/* Returns false if buf does not start with a valid header */
+extern bool I2CSlaveCapture_open(I2CSlaveCapture_Reader *reader,
+                                 const uint8_t *buf, size_t size);
+
+/* Returns false at the end of the capture or on a malformed record */
+extern bool I2CSlaveCapture_next(I2CSlaveCapture_Reader *reader,
+                                 I2CSlaveCapture_Record *record);
+
+/*
+ *  Writer for generated captures. Times must not go backwards. Every
+ *  function returns false once buf is full.
+ */
+extern bool I2CSlaveCapture_writerInit(I2CSlaveCapture_Writer *writer,
+                                       uint8_t *buf, size_t size,
+                                       uint32_t bitRate);
+extern bool I2CSlaveCapture_start(I2CSlaveCapture_Writer *writer,
+                                  uint64_t timeNs);
+extern bool I2CSlaveCapture_addr(I2CSlaveCapture_Writer *writer,
+                                 uint64_t timeNs, uint8_t address, bool read);
+extern bool I2CSlaveCapture_data(I2CSlaveCapture_Writer *writer,
+                                 uint64_t timeNs, const uint8_t *data,
+                                 size_t count);
+extern bool I2CSlaveCapture_stop(I2CSlaveCapture_Writer *writer,
+                                 uint64_t timeNs);
+extern bool I2CSlaveCapture_lines(I2CSlaveCapture_Writer *writer,
+                                  uint64_t timeNs, bool scl, bool sda);
+
+#endif /* I2CSLAVECAPTURE_H_ */
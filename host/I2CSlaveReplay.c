@@ -0,0 +1,498 @@
+/*
+ *  ======== I2CSlaveReplay.c ========
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <inc/hw_i2c.h>
+
+#include "HostKernel.h"
+#include "I2CTivaSlave.h"
+#include "I2CSlaveReplay.h"
+
+/* Default time step while the slave holds SCL */
+#define REPLAY_POLL_NS          1000
+
+/* A master gives up on a byte held longer than this */
+#define REPLAY_STRETCH_LIMIT_NS 500000000ULL
+
+/*
+ *  ======== isOwnAddress ========
+ */
+static bool isOwnAddress(I2CSlaveSim_Object *sim, uint8_t address)
+{
+    return (address == sim->ownAddr ||
+        (sim->ownAddr2En && address == sim->ownAddr2));
+}
+
+/*
+ *  ======== retireMsgs ========
+ *  Removes closed messages that were completely delivered, oldest first.
+ */
+static void retireMsgs(I2CSlaveReplay_Object *replay)
+{
+    uint64_t            latency;
+    I2CSlaveReplay_Msg *msg;
+
+    while (replay->msgCount) {
+        msg = &replay->msgs[replay->msgHead];
+        if (msg->endNs == 0 || msg->delivered < msg->count) {
+            break;
+        }
+
+        replay->msgHead = (replay->msgHead + 1) % I2CSLAVEREPLAY_MSG_DEPTH;
+        replay->msgCount--;
+        if (msg->cached) {
+            replay->report.cached++;
+            continue;
+        }
+
+        latency = HostKernel_now() - msg->endNs;
+        replay->report.delivered++;
+        replay->report.latencySumNs += latency;
+        if (replay->report.delivered == 1 ||
+            latency < replay->report.latencyMinNs) {
+            replay->report.latencyMinNs = latency;
+        }
+        if (latency > replay->report.latencyMaxNs) {
+            replay->report.latencyMaxNs = latency;
+        }
+    }
+}
+
+/*
+ *  ======== openMsg ========
+ */
+static void openMsg(I2CSlaveReplay_Object *replay)
+{
+    I2CSlaveReplay_Msg *msg;
+
+    /* The application fell too far behind; forget the oldest message */
+    if (replay->msgCount == I2CSLAVEREPLAY_MSG_DEPTH) {
+        replay->msgHead = (replay->msgHead + 1) % I2CSLAVEREPLAY_MSG_DEPTH;
+        replay->msgCount--;
+    }
+
+    msg = &replay->msgs[(replay->msgHead + replay->msgCount) %
+        I2CSLAVEREPLAY_MSG_DEPTH];
+    msg->endNs = 0;
+    msg->count = 0;
+    msg->delivered = 0;
+    msg->cached = false;
+    replay->msgCount++;
+}
+
+/*
+ *  ======== lastMsg ========
+ */
+static I2CSlaveReplay_Msg *lastMsg(I2CSlaveReplay_Object *replay)
+{
+    return (&replay->msgs[(replay->msgHead + replay->msgCount - 1) %
+        I2CSLAVEREPLAY_MSG_DEPTH]);
+}
+
+/*
+ *  ======== endTransaction ========
+ *  Closes the current transaction at a STOP or repeated START.
+ */
+static void endTransaction(I2CSlaveReplay_Object *replay)
+{
+    I2CSlaveReplay_Msg *msg;
+
+    if (!replay->addressed) {
+        return;
+    }
+
+    if (replay->read) {
+        replay->report.readMessages++;
+    }
+    else if (replay->general) {
+        replay->report.generalCalls++;
+    }
+    else if (replay->msgCount) {
+        msg = lastMsg(replay);
+        if (msg->count == 0) {
+            replay->msgCount--;
+        }
+        else {
+            msg->endNs = HostKernel_now() ? HostKernel_now() : 1;
+            replay->report.writeMessages++;
+            retireMsgs(replay);
+        }
+    }
+
+    replay->addressed = false;
+}
+
+/*
+ *  ======== checkCacheHit ========
+ *  Called after a START or STOP reached the driver. A master write answered
+ *  from the reply cache never reaches the application, so it is retired
+ *  here instead of being counted as undelivered.
+ */
+static void checkCacheHit(I2CSlaveReplay_Object *replay)
+{
+    I2CTivaSlave_Stats  stats;
+    I2CSlaveReplay_Msg *msg;
+
+    if (replay->handle == NULL) {
+        return;
+    }
+
+    I2CTivaSlave_getStats(replay->handle, &stats);
+    if (stats.cacheHits != replay->cacheHits) {
+        replay->cacheHits = stats.cacheHits;
+        if (replay->msgCount) {
+            msg = lastMsg(replay);
+            if (msg->endNs != 0) {
+                msg->delivered = msg->count;
+                msg->cached = true;
+                retireMsgs(replay);
+            }
+        }
+    }
+}
+
+/*
+ *  ======== endStretch ========
+ */
+static void endStretch(I2CSlaveReplay_Object *replay)
+{
+    uint64_t    stretch;
+
+    if (!replay->stretching) {
+        return;
+    }
+
+    stretch = HostKernel_now() - replay->stretchStartNs;
+    replay->report.stretchNs += stretch;
+    if (stretch > replay->report.stretchMaxNs) {
+        replay->report.stretchMaxNs = stretch;
+    }
+    replay->stretching = false;
+}
+
+/*
+ *  ======== stretch ========
+ *  The slave holds SCL: wait a little and retry the same event, or give the
+ *  byte up once the stretch limit is exceeded.
+ */
+static bool stretch(I2CSlaveReplay_Object *replay)
+{
+    if (!replay->stretching) {
+        replay->stretching = true;
+        replay->stretchStartNs = HostKernel_now();
+        replay->report.stretches++;
+    }
+
+    if (HostKernel_now() - replay->stretchStartNs < replay->stretchLimitNs) {
+        replay->busFreeNs = HostKernel_now() + replay->pollNs;
+        return (true);
+    }
+
+    /*
+     * The master gives up and the bus moves on without the byte. A byte
+     * written while the FIFO or a slow ISR still has no room is lost.
+     */
+    endStretch(replay);
+    replay->report.abandoned++;
+    replay->sim->rxPending = false;
+
+    if (replay->record.type == I2CSLAVECAPTURE_DATA &&
+        (replay->read || I2CSlaveSim_isRxFull(replay->sim))) {
+        if (replay->read) {
+            replay->report.mismatches++;
+        }
+        if (++replay->index == replay->record.count) {
+            replay->haveRecord = false;
+        }
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== I2CSlaveReplay_construct ========
+ */
+bool I2CSlaveReplay_construct(I2CSlaveReplay_Object *replay,
+    const uint8_t *buf, size_t size, I2CSlaveSim_Object *sim,
+    I2CSlave_Handle handle)
+{
+    memset(replay, 0, sizeof(*replay));
+
+    if (!I2CSlaveCapture_open(&replay->reader, buf, size)) {
+        return (false);
+    }
+
+    replay->sim = sim;
+    replay->handle = handle;
+    replay->byteNs = 9000000000ULL / replay->reader.bitRate;
+    replay->pollNs = REPLAY_POLL_NS;
+    replay->stretchLimitNs = REPLAY_STRETCH_LIMIT_NS;
+    replay->claimedPos = SIZE_MAX;
+
+    return (true);
+}
+
+/*
+ *  ======== I2CSlaveReplay_nextTime ========
+ */
+bool I2CSlaveReplay_nextTime(I2CSlaveReplay_Object *replay, uint64_t *timeNs)
+{
+    size_t                  recordPos;
+    I2CSlaveCapture_Record *record = &replay->record;
+
+    if (!replay->haveRecord) {
+        recordPos = replay->reader.pos;
+        if (!I2CSlaveCapture_next(&replay->reader, record)) {
+            return (false);
+        }
+        replay->haveRecord = true;
+        replay->index = 0;
+        if (record->type == I2CSLAVECAPTURE_ADDR) {
+            replay->readPos = recordPos;
+        }
+    }
+
+    *timeNs = record->timeNs + replay->index * replay->byteNs;
+    if (*timeNs < replay->busFreeNs) {
+        *timeNs = replay->busFreeNs;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== I2CSlaveReplay_step ========
+ */
+bool I2CSlaveReplay_step(I2CSlaveReplay_Object *replay)
+{
+    int                     data;
+    uint64_t                timeNs;
+    I2CSlaveCapture_Record *record = &replay->record;
+
+    if (!I2CSlaveReplay_nextTime(replay, &timeNs)) {
+        return (false);
+    }
+    HostKernel_advanceTo(timeNs);
+
+    /* Nothing happens on the bus while a received byte holds SCL */
+    if (I2CSlaveSim_isRxFull(replay->sim)) {
+        return (stretch(replay));
+    }
+    if (record->type != I2CSLAVECAPTURE_DATA || !replay->read) {
+        endStretch(replay);
+    }
+
+    switch (record->type) {
+        case I2CSLAVECAPTURE_START:
+            replay->haveRecord = false;
+            break;
+
+        case I2CSLAVECAPTURE_ADDR:
+            endTransaction(replay);
+            replay->read = record->read;
+            replay->general = record->address == 0x00 && !record->read;
+            replay->addressed = I2CSlaveSim_start(replay->sim,
+                record->address, record->read);
+            checkCacheHit(replay);
+            if (replay->addressed) {
+                replay->report.transactions++;
+                /* General calls go to the subscribers, not to the reader */
+                if (!record->read && !replay->general) {
+                    openMsg(replay);
+                }
+            }
+            else if (isOwnAddress(replay->sim, record->address)) {
+                replay->report.nacks++;
+            }
+            replay->busFreeNs = HostKernel_now() + replay->byteNs;
+            replay->haveRecord = false;
+            break;
+
+        case I2CSLAVECAPTURE_DATA:
+            if (!replay->addressed) {
+                replay->haveRecord = false;
+                break;
+            }
+
+            if (replay->read) {
+                data = I2CSlaveSim_read(replay->sim,
+                    replay->index + 1 < record->count);
+                if (data < 0) {
+                    return (stretch(replay));
+                }
+                endStretch(replay);
+                replay->report.bytesRead++;
+                if (data != record->data[replay->index]) {
+                    replay->report.mismatches++;
+                }
+            }
+            else if (replay->general) {
+                if (I2CSlaveSim_write(replay->sim,
+                        record->data[replay->index])) {
+                    replay->report.bytesWritten++;
+                }
+                else {
+                    replay->report.nacks++;
+                }
+            }
+            else {
+                /* Counted first, the ISR may already deliver the byte */
+                lastMsg(replay)->count++;
+                if (I2CSlaveSim_write(replay->sim,
+                        record->data[replay->index])) {
+                    replay->report.bytesWritten++;
+                }
+                else {
+                    lastMsg(replay)->count--;
+                    replay->report.nacks++;
+                }
+            }
+
+            replay->busFreeNs = HostKernel_now() + replay->byteNs;
+            if (++replay->index == record->count) {
+                replay->haveRecord = false;
+            }
+            break;
+
+        case I2CSLAVECAPTURE_STOP:
+            endTransaction(replay);
+            I2CSlaveSim_stop(replay->sim);
+            checkCacheHit(replay);
+            replay->haveRecord = false;
+            break;
+
+        case I2CSLAVECAPTURE_LINES:
+            I2CSlaveSim_setLines(replay->sim,
+                ((record->lines & 1) ? I2C_MBMON_SCL : 0) |
+                ((record->lines & 2) ? I2C_MBMON_SDA : 0));
+            replay->haveRecord = false;
+            break;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== I2CSlaveReplay_idle ========
+ */
+bool I2CSlaveReplay_idle(void *arg)
+{
+    return (I2CSlaveReplay_step((I2CSlaveReplay_Object *)arg));
+}
+
+/*
+ *  ======== I2CSlaveReplay_done ========
+ */
+bool I2CSlaveReplay_done(I2CSlaveReplay_Object *replay)
+{
+    return (!replay->haveRecord &&
+        (replay->reader.error || replay->reader.pos >= replay->reader.size));
+}
+
+/*
+ *  ======== I2CSlaveReplay_markDelivered ========
+ */
+void I2CSlaveReplay_markDelivered(I2CSlaveReplay_Object *replay, size_t count)
+{
+    size_t              take;
+    unsigned int        i;
+    I2CSlaveReplay_Msg *msg;
+
+    for (i = 0; count && i < replay->msgCount; i++) {
+        msg = &replay->msgs[(replay->msgHead + i) % I2CSLAVEREPLAY_MSG_DEPTH];
+        take = msg->count - msg->delivered;
+        if (take > count) {
+            take = count;
+        }
+        msg->delivered += take;
+        count -= take;
+    }
+
+    retireMsgs(replay);
+}
+
+/*
+ *  ======== I2CSlaveReplay_nextReply ========
+ */
+size_t I2CSlaveReplay_nextReply(I2CSlaveReplay_Object *replay, void *buf,
+    size_t size)
+{
+    size_t                  pos;
+    size_t                  addrPos = SIZE_MAX;
+    I2CSlaveCapture_Reader  scan = replay->reader;
+    I2CSlaveCapture_Record  record;
+
+    /*
+     * The master is still writing; the reply is not due yet. A handler
+     * called from the ISR for the last byte may already have it.
+     */
+    if (replay->addressed && !replay->read && replay->haveRecord &&
+        (replay->record.type != I2CSLAVECAPTURE_DATA ||
+         replay->index + 1 < replay->record.count)) {
+        return (0);
+    }
+
+    /* Start at the current read transaction, or at the current record */
+    if (replay->addressed && replay->read) {
+        scan.pos = replay->readPos;
+    }
+    else if (replay->haveRecord &&
+             replay->record.type == I2CSLAVECAPTURE_ADDR) {
+        scan.pos = replay->readPos;
+    }
+
+    while (true) {
+        pos = scan.pos;
+        if (!I2CSlaveCapture_next(&scan, &record)) {
+            return (0);
+        }
+
+        if (record.type == I2CSLAVECAPTURE_ADDR) {
+            if (!isOwnAddress(replay->sim, record.address)) {
+                addrPos = SIZE_MAX;
+            }
+            else if (!record.read) {
+                /* The master writes again before reading */
+                return (0);
+            }
+            else {
+                addrPos = pos;
+            }
+        }
+        else if (record.type == I2CSLAVECAPTURE_DATA && addrPos != SIZE_MAX) {
+            if (addrPos == replay->claimedPos) {
+                return (0);
+            }
+            replay->claimedPos = addrPos;
+            if (record.count < size) {
+                size = record.count;
+            }
+            memcpy(buf, record.data, size);
+            return (size);
+        }
+    }
+}
+
+/*
+ *  ======== I2CSlaveReplay_getReport ========
+ */
+void I2CSlaveReplay_getReport(I2CSlaveReplay_Object *replay,
+    I2CSlaveReplay_Report *report)
+{
+    I2CTivaSlave_Stats  stats;
+
+    *report = replay->report;
+    report->txStretches = replay->sim->txStretches;
+    report->txStretchNs = replay->sim->txStretchNs;
+
+    if (replay->handle != NULL) {
+        I2CTivaSlave_getStats(replay->handle, &stats);
+        report->rxOverruns = stats.rxOverruns;
+        report->txStuffed = stats.txStuffed;
+        report->txDiscarded = stats.txDiscarded;
+    }
+}
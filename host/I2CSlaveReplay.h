@@ -0,0 +1,128 @@
+/*
+ *  ======== I2CSlaveReplay.h ========
+ *  Deterministic replay of an I2C capture against the driver.
+ *
+ *  The engine plays the master side of a capture into the register model,
+ *  which raises the driver interrupt for every bus event. It is run as the
+ *  HostKernel idle function, so bus traffic is produced whenever the
+ *  application task blocks, and simulated time follows the capture
+ *  timestamps. Where the slave holds SCL the bus is delayed, just like a
+ *  real master that honours clock stretching.
+ */
+
+#ifndef I2CSLAVEREPLAY_H_
+#define I2CSLAVEREPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "I2CSlave.h"
+#include "I2CSlaveCapture.h"
+#include "I2CSlaveSim.h"
+
+/* Master writes tracked between the bus and the application */
+#define I2CSLAVEREPLAY_MSG_DEPTH    64
+
+typedef struct I2CSlaveReplay_Report {
+    uint32_t        transactions;   /* Transactions addressed to the slave */
+    uint32_t        writeMessages;  /* Completed master writes */
+    uint32_t        readMessages;   /* Completed master reads */
+    uint32_t        bytesWritten;   /* Bytes sent by the master */
+    uint32_t        bytesRead;      /* Bytes clocked out by the slave */
+    uint32_t        nacks;          /* Bytes or addresses not acknowledged */
+    uint32_t        mismatches;     /* Read bytes that differ from capture */
+    uint32_t        stretches;      /* Bytes on which the slave held SCL */
+    uint64_t        stretchNs;      /* Total time SCL was held */
+    uint64_t        stretchMaxNs;   /* Longest single stretch */
+    uint32_t        abandoned;      /* Bytes given up after stretchLimitNs */
+    uint32_t        txStretches;    /* TREQs raised with nothing to send */
+    uint64_t        txStretchNs;    /* Time from those TREQs to the load */
+    uint32_t        delivered;      /* Master writes seen by the application */
+    uint32_t        cached;         /* Master writes answered by the driver */
+    uint32_t        generalCalls;   /* Acknowledged general call writes */
+    uint64_t        latencySumNs;   /* End of master write to delivery */
+    uint64_t        latencyMinNs;
+    uint64_t        latencyMaxNs;
+    uint32_t        rxOverruns;     /* From the driver statistics */
+    uint32_t        txStuffed;      /* From the driver statistics */
+    uint32_t        txDiscarded;    /* From the driver statistics */
+} I2CSlaveReplay_Report;
+
+typedef struct I2CSlaveReplay_Msg {
+    uint64_t        endNs;          /* Time of the STOP, 0 while open */
+    size_t          count;          /* Bytes sent by the master */
+    size_t          delivered;      /* Bytes handed to the application */
+    bool            cached;         /* Answered by the driver reply cache */
+} I2CSlaveReplay_Msg;
+
+typedef struct I2CSlaveReplay_Object {
+    I2CSlaveCapture_Reader  reader;
+    I2CSlaveCapture_Record  record;     /* Record being played */
+    bool                    haveRecord;
+    size_t                  index;      /* Next byte of a DATA record */
+    bool                    addressed;  /* Current transaction is ours */
+    bool                    read;       /* Current transaction direction */
+    bool                    general;    /* Current transaction is a general call */
+    size_t                  readPos;    /* Reader offset of the read ADDR */
+    size_t                  claimedPos; /* Read already answered by the app */
+    bool                    stretching;
+    uint64_t                stretchStartNs;
+    uint64_t                busFreeNs;  /* Earliest time of the next event */
+    uint64_t                byteNs;     /* Time of one byte incl. ACK */
+    uint64_t                pollNs;     /* Time step while SCL is held */
+    uint64_t                stretchLimitNs;
+    I2CSlaveSim_Object     *sim;
+    I2CSlave_Handle         handle;
+    I2CSlaveReplay_Msg      msgs[I2CSLAVEREPLAY_MSG_DEPTH];
+    unsigned int            msgHead;
+    unsigned int            msgCount;
+    uint32_t                cacheHits;  /* Driver reply cache hits seen */
+    I2CSlaveReplay_Report   report;
+} I2CSlaveReplay_Object;
+
+/*
+ *  Prepare to replay the capture in buf against sim. handle is the opened
+ *  driver instance using that peripheral. Returns false for an invalid
+ *  capture.
+ */
+extern bool I2CSlaveReplay_construct(I2CSlaveReplay_Object *replay,
+                                     const uint8_t *buf, size_t size,
+                                     I2CSlaveSim_Object *sim,
+                                     I2CSlave_Handle handle);
+
+/* Play the next bus event. Returns false at the end of the capture */
+extern bool I2CSlaveReplay_step(I2CSlaveReplay_Object *replay);
+
+/*
+ *  Simulated time of the next bus event, for running several engines on one
+ *  timeline: always step the engine with the earliest event. Returns false
+ *  at the end of the capture.
+ */
+extern bool I2CSlaveReplay_nextTime(I2CSlaveReplay_Object *replay,
+                                    uint64_t *timeNs);
+
+/* HostKernel idle function, arg is the replay object */
+extern bool I2CSlaveReplay_idle(void *arg);
+
+extern bool I2CSlaveReplay_done(I2CSlaveReplay_Object *replay);
+
+/*
+ *  Tell the engine the application received count bytes of master writes.
+ *  Bytes are matched to messages in order to measure delivery latency.
+ */
+extern void I2CSlaveReplay_markDelivered(I2CSlaveReplay_Object *replay,
+                                         size_t count);
+
+/*
+ *  Returns the captured reply of the next master read if it comes before
+ *  any further master write, so the application can answer like the
+ *  captured device did. Each read is handed out once.
+ */
+extern size_t I2CSlaveReplay_nextReply(I2CSlaveReplay_Object *replay,
+                                       void *buf, size_t size);
+
+extern void I2CSlaveReplay_getReport(I2CSlaveReplay_Object *replay,
+                                     I2CSlaveReplay_Report *report);
+
+#endif /* I2CSLAVEREPLAY_H_ */
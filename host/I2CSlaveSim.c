@@ -0,0 +1,658 @@
+/*
+ *  ======== I2CSlaveSim.c ========
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <inc/hw_i2c.h>
+#include <inc/hw_memmap.h>
+#include <driverlib/i2c.h>
+#include <driverlib/sysctl.h>
+
+#include "HostKernel.h"
+#include "I2CSlaveSim.h"
+
+static I2CSlaveSim_Object *simList;
+
+/* I2Cn_BASE of SYSCTL_PERIPH_I2Cn */
+static const uint32_t periphBase[] = {
+    I2C0_BASE, I2C1_BASE, I2C2_BASE, I2C3_BASE, I2C4_BASE,
+    I2C5_BASE, I2C6_BASE, I2C7_BASE, I2C8_BASE, I2C9_BASE
+};
+
+/*
+ *  ======== findSim ========
+ */
+static I2CSlaveSim_Object *findSim(uint32_t baseAddr)
+{
+    I2CSlaveSim_Object *sim;
+
+    for (sim = simList; sim != NULL; sim = sim->next) {
+        if (sim->baseAddr == baseAddr) {
+            return (sim);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== raise ========
+ *  Sets raw interrupt flags and runs the driver ISR if any are unmasked.
+ */
+static void raise(I2CSlaveSim_Object *sim, uint32_t flags)
+{
+    uint32_t    reads;
+    uint64_t    startNs;
+
+    sim->ris |= flags;
+
+    if (sim->ris & sim->imr) {
+        reads = sim->rxReads;
+        startNs = HostKernel_now() > sim->cpuFreeNs ?
+            HostKernel_now() : sim->cpuFreeNs;
+
+        HostKernel_raise(sim->intNum);
+
+        /* Bytes taken by a previous interrupt still running stay counted */
+        if (HostKernel_now() >= sim->cpuFreeNs) {
+            sim->rxTaken = 0;
+        }
+        sim->rxTaken += sim->rxReads - reads;
+        sim->cpuFreeNs = startNs + sim->isrNs +
+            (uint64_t)(sim->rxReads - reads) * sim->isrByteNs;
+    }
+}
+
+/*
+ *  ======== requestTx ========
+ *  The master wants the next byte: TREQ is set and SCL held until the
+ *  driver writes the data register.
+ */
+static void requestTx(I2CSlaveSim_Object *sim)
+{
+    sim->scsr |= I2C_SCSR_TREQ;
+
+    if (!sim->txWaiting) {
+        sim->txWaiting = true;
+        sim->txWaitStartNs = HostKernel_now();
+        sim->txStretches++;
+    }
+}
+
+/*
+ *  ======== txReady ========
+ *  A byte is loaded for the master to read.
+ */
+static bool txReady(I2CSlaveSim_Object *sim)
+{
+    return (sim->txFifoEnabled ? sim->txFifoCount != 0 : sim->txLoaded);
+}
+
+/*
+ *  ======== endTxWait ========
+ */
+static void endTxWait(I2CSlaveSim_Object *sim)
+{
+    if (sim->txWaiting) {
+        sim->txWaiting = false;
+        sim->txStretchNs += HostKernel_now() - sim->txWaitStartNs;
+    }
+}
+
+/*
+ *  ======== I2CSlaveSim_construct ========
+ */
+void I2CSlaveSim_construct(I2CSlaveSim_Object *sim, uint32_t baseAddr,
+    int intNum)
+{
+    sim->baseAddr = baseAddr;
+    sim->intNum = intNum;
+    sim->enabled = false;
+    sim->ownAddr = 0;
+    sim->ownAddr2 = 0;
+    sim->ownAddr2En = false;
+    sim->imr = 0;
+    sim->ris = 0;
+    sim->scsr = 0;
+    sim->sdr = 0;
+    sim->rxPending = false;
+    sim->txLoaded = false;
+    sim->ackOverride = false;
+    sim->ackValue = true;
+    sim->lineState = I2C_MBMON_SCL | I2C_MBMON_SDA;
+    sim->addressed = false;
+    sim->firstByte = false;
+    sim->txWaiting = false;
+    sim->txStretches = 0;
+    sim->txStretchNs = 0;
+    sim->rxFifoEnabled = false;
+    sim->rxFifoTrigger = 1;
+    sim->rxFifoHead = 0;
+    sim->rxFifoCount = 0;
+    sim->txFifoEnabled = false;
+    sim->txFifoTrigger = 0;
+    sim->txFifoHead = 0;
+    sim->txFifoCount = 0;
+    sim->highSpeed = false;
+    sim->hsTransactions = 0;
+    sim->isrNs = 0;
+    sim->isrByteNs = 0;
+    sim->cpuFreeNs = 0;
+    sim->rxTaken = 0;
+    sim->rxReads = 0;
+    sim->next = simList;
+    simList = sim;
+}
+
+/*
+ *  ======== I2CSlaveSim_destruct ========
+ */
+void I2CSlaveSim_destruct(I2CSlaveSim_Object *sim)
+{
+    I2CSlaveSim_Object **link;
+
+    for (link = &simList; *link != NULL; link = &(*link)->next) {
+        if (*link == sim) {
+            *link = sim->next;
+            break;
+        }
+    }
+}
+
+/*
+ *  ======== I2CSlaveSim_start ========
+ */
+bool I2CSlaveSim_start(I2CSlaveSim_Object *sim, uint8_t address, bool read)
+{
+    if ((address & 0x7C) == 0x04) {
+        sim->highSpeed = true;
+        return (false);
+    }
+
+    sim->scsr = 0;
+    sim->rxPending = false;
+    sim->txLoaded = false;
+    endTxWait(sim);
+    sim->addressed = sim->enabled && (address == sim->ownAddr ||
+        (sim->ownAddr2En && address == sim->ownAddr2));
+
+    if (!sim->addressed) {
+        return (false);
+    }
+
+    if (address != sim->ownAddr) {
+        sim->scsr |= I2C_SCSR_OAR2SEL;
+    }
+    if (sim->highSpeed) {
+        sim->hsTransactions++;
+    }
+    sim->firstByte = !read;
+
+    /*
+     * The START interrupt is taken while the address byte is still being
+     * clocked in. For a read, data is requested when the master clocks the
+     * first byte.
+     */
+    raise(sim, I2C_SLAVE_INT_START);
+
+    return (true);
+}
+
+/*
+ *  ======== I2CSlaveSim_write ========
+ */
+bool I2CSlaveSim_write(I2CSlaveSim_Object *sim, uint8_t data)
+{
+    bool ack;
+
+    if (!sim->addressed) {
+        return (false);
+    }
+
+    ack = sim->ackOverride ? sim->ackValue : true;
+
+    /* The FIFO has no first byte flag and raises its request at a level */
+    if (sim->rxFifoEnabled) {
+        sim->firstByte = false;
+        if (sim->rxFifoCount < I2CSLAVESIM_FIFO_DEPTH) {
+            sim->rxFifo[(sim->rxFifoHead + sim->rxFifoCount) %
+                I2CSLAVESIM_FIFO_DEPTH] = data;
+            sim->rxFifoCount++;
+        }
+        if (sim->rxFifoCount >= sim->rxFifoTrigger) {
+            raise(sim, I2C_SLAVE_INT_RX_FIFO_REQ);
+        }
+        return (ack);
+    }
+
+    /* The received byte replaces whatever the driver wrote to I2CSDR */
+    sim->sdr = data;
+    sim->txLoaded = false;
+    sim->rxPending = true;
+    sim->scsr |= I2C_SCSR_RREQ;
+    if (sim->firstByte) {
+        sim->scsr |= I2C_SCSR_FBR;
+        sim->firstByte = false;
+    }
+    raise(sim, I2C_SLAVE_INT_DATA);
+
+    return (ack);
+}
+
+/*
+ *  ======== I2CSlaveSim_read ========
+ */
+int I2CSlaveSim_read(I2CSlaveSim_Object *sim, bool more)
+{
+    uint8_t data;
+
+    if (!sim->addressed) {
+        return (0xFF);
+    }
+
+    if (!txReady(sim) && !(sim->scsr & I2C_SCSR_TREQ)) {
+        requestTx(sim);
+        raise(sim, I2C_SLAVE_INT_DATA);
+    }
+
+    if (!txReady(sim) || HostKernel_now() < sim->cpuFreeNs) {
+        return (-1);
+    }
+
+    if (sim->txFifoEnabled) {
+        data = sim->txFifo[sim->txFifoHead];
+        sim->txFifoHead = (sim->txFifoHead + 1) % I2CSLAVESIM_FIFO_DEPTH;
+        sim->txFifoCount--;
+        if (sim->txFifoCount <= sim->txFifoTrigger) {
+            raise(sim, I2C_SLAVE_INT_TX_FIFO_REQ);
+        }
+    }
+    else {
+        data = sim->sdr;
+        sim->txLoaded = false;
+    }
+
+    if (more && !txReady(sim)) {
+        requestTx(sim);
+        raise(sim, I2C_SLAVE_INT_DATA);
+    }
+
+    return (data);
+}
+
+/*
+ *  ======== I2CSlaveSim_stop ========
+ */
+void I2CSlaveSim_stop(I2CSlaveSim_Object *sim)
+{
+    sim->highSpeed = false;
+
+    if (!sim->addressed) {
+        return;
+    }
+
+    sim->addressed = false;
+    sim->scsr &= ~(I2C_SCSR_TREQ | I2C_SCSR_OAR2SEL);
+    endTxWait(sim);
+    raise(sim, I2C_SLAVE_INT_STOP);
+}
+
+/*
+ *  ======== I2CSlaveSim_setLines ========
+ */
+void I2CSlaveSim_setLines(I2CSlaveSim_Object *sim, uint32_t lineState)
+{
+    sim->lineState = lineState;
+}
+
+/*
+ *  ======== I2CSlaveSim_isStretching ========
+ */
+bool I2CSlaveSim_isStretching(I2CSlaveSim_Object *sim)
+{
+    return (I2CSlaveSim_isRxFull(sim) ||
+        ((sim->scsr & I2C_SCSR_TREQ) && !txReady(sim)));
+}
+
+/*
+ *  ======== I2CSlaveSim_isRxFull ========
+ */
+bool I2CSlaveSim_isRxFull(I2CSlaveSim_Object *sim)
+{
+    unsigned int held;
+
+    held = sim->rxFifoEnabled ? sim->rxFifoCount : sim->rxPending;
+    if (HostKernel_now() < sim->cpuFreeNs) {
+        held += sim->rxTaken;
+    }
+
+    return (held >= (sim->rxFifoEnabled ? I2CSLAVESIM_FIFO_DEPTH : 1));
+}
+
+/*
+ *  ======== driverlib slave API ========
+ */
+void I2CSlaveInit(uint32_t ui32Base, uint8_t ui8SlaveAddr)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->ownAddr = ui8SlaveAddr;
+        sim->enabled = true;
+    }
+}
+
+void I2CSlaveAddressSet(uint32_t ui32Base, uint8_t ui8AddrNum,
+    uint8_t ui8SlaveAddr)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL) {
+        return;
+    }
+
+    if (ui8AddrNum == 0) {
+        sim->ownAddr = ui8SlaveAddr;
+    }
+    else {
+        sim->ownAddr2 = ui8SlaveAddr;
+        sim->ownAddr2En = true;
+    }
+}
+
+void I2CSlaveEnable(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->enabled = true;
+    }
+}
+
+void I2CSlaveDisable(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->enabled = false;
+    }
+}
+
+uint32_t I2CSlaveStatus(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    return (sim != NULL ? sim->scsr : 0);
+}
+
+void I2CSlaveDataPut(uint32_t ui32Base, uint8_t ui8Data)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL) {
+        return;
+    }
+
+    /*
+     * The register is written either way, but only a write in answer to
+     * TREQ releases SCL and is clocked out.
+     */
+    sim->sdr = ui8Data;
+    if (sim->scsr & I2C_SCSR_TREQ) {
+        sim->txLoaded = true;
+        sim->scsr &= ~I2C_SCSR_TREQ;
+        endTxWait(sim);
+    }
+}
+
+uint32_t I2CSlaveDataGet(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL) {
+        return (0);
+    }
+
+    sim->rxPending = false;
+    sim->scsr &= ~(I2C_SCSR_RREQ | I2C_SCSR_FBR);
+    sim->rxReads++;
+
+    return (sim->sdr);
+}
+
+void I2CSlaveIntEnableEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->imr |= ui32IntFlags;
+    }
+}
+
+void I2CSlaveIntDisableEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->imr &= ~ui32IntFlags;
+    }
+}
+
+void I2CSlaveIntDisable(uint32_t ui32Base)
+{
+    I2CSlaveIntDisableEx(ui32Base, I2C_SLAVE_INT_DATA);
+}
+
+uint32_t I2CSlaveIntStatusEx(uint32_t ui32Base, bool bMasked)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL) {
+        return (0);
+    }
+
+    return (bMasked ? (sim->ris & sim->imr) : sim->ris);
+}
+
+void I2CSlaveIntClearEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->ris &= ~ui32IntFlags;
+    }
+}
+
+void I2CSlaveFIFOEnable(uint32_t ui32Base, uint32_t ui32Config)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->rxFifoEnabled = (ui32Config & I2C_SLAVE_RX_FIFO_ENABLE) != 0;
+        sim->txFifoEnabled = (ui32Config & I2C_SLAVE_TX_FIFO_ENABLE) != 0;
+    }
+}
+
+void I2CSlaveFIFODisable(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->rxFifoEnabled = false;
+        sim->txFifoEnabled = false;
+    }
+}
+
+void I2CSlaveACKOverride(uint32_t ui32Base, bool bEnable)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->ackOverride = bEnable;
+    }
+}
+
+void I2CSlaveACKValueSet(uint32_t ui32Base, bool bACK)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->ackValue = bACK;
+    }
+}
+
+void I2CRxFIFOConfigSet(uint32_t ui32Base, uint32_t ui32Config)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->rxFifoTrigger = (ui32Config >> 16) & 0x7;
+        if (sim->rxFifoTrigger == 0) {
+            sim->rxFifoTrigger = 1;
+        }
+    }
+}
+
+void I2CRxFIFOFlush(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->rxFifoHead = 0;
+        sim->rxFifoCount = 0;
+    }
+}
+
+void I2CTxFIFOConfigSet(uint32_t ui32Base, uint32_t ui32Config)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->txFifoTrigger = ui32Config & 0x7;
+    }
+}
+
+void I2CTxFIFOFlush(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim != NULL) {
+        sim->txFifoHead = 0;
+        sim->txFifoCount = 0;
+    }
+}
+
+void I2CFIFODataPut(uint32_t ui32Base, uint8_t ui8Data)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL || sim->txFifoCount == I2CSLAVESIM_FIFO_DEPTH) {
+        return;
+    }
+
+    sim->txFifo[(sim->txFifoHead + sim->txFifoCount) %
+        I2CSLAVESIM_FIFO_DEPTH] = ui8Data;
+    sim->txFifoCount++;
+
+    /* A master stretched on the empty FIFO gets the byte */
+    if (sim->txFifoEnabled && (sim->scsr & I2C_SCSR_TREQ)) {
+        sim->scsr &= ~I2C_SCSR_TREQ;
+        endTxWait(sim);
+    }
+}
+
+uint32_t I2CFIFOStatus(uint32_t ui32Base)
+{
+    uint32_t            status = 0;
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL || sim->rxFifoCount == 0) {
+        status |= I2C_FIFO_RX_EMPTY;
+    }
+    if (sim != NULL && sim->rxFifoCount == I2CSLAVESIM_FIFO_DEPTH) {
+        status |= I2C_FIFO_RX_FULL;
+    }
+    if (sim == NULL || sim->rxFifoCount < sim->rxFifoTrigger) {
+        status |= I2C_FIFO_RX_BELOW_TRIG_LEVEL;
+    }
+    if (sim == NULL || sim->txFifoCount == 0) {
+        status |= I2C_FIFO_TX_EMPTY;
+    }
+    if (sim != NULL && sim->txFifoCount == I2CSLAVESIM_FIFO_DEPTH) {
+        status |= I2C_FIFO_TX_FULL;
+    }
+    if (sim == NULL || sim->txFifoCount <= sim->txFifoTrigger) {
+        status |= I2C_FIFO_TX_BELOW_TRIG_LEVEL;
+    }
+
+    return (status);
+}
+
+uint32_t I2CFIFODataGetNonBlocking(uint32_t ui32Base, uint8_t *pui8Data)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    if (sim == NULL || sim->rxFifoCount == 0) {
+        return (0);
+    }
+
+    *pui8Data = sim->rxFifo[sim->rxFifoHead];
+    sim->rxFifoHead = (sim->rxFifoHead + 1) % I2CSLAVESIM_FIFO_DEPTH;
+    sim->rxFifoCount--;
+    sim->rxReads++;
+
+    return (1);
+}
+
+uint32_t I2CMasterLineStateGet(uint32_t ui32Base)
+{
+    I2CSlaveSim_Object *sim = findSim(ui32Base);
+
+    return (sim != NULL ? sim->lineState : (I2C_MBMON_SCL | I2C_MBMON_SDA));
+}
+
+/*
+ *  ======== driverlib SysCtl ========
+ *  Resetting an I2C peripheral clears its registers and abandons the
+ *  transaction in progress. The line levels come from the bus.
+ */
+void SysCtlPeripheralReset(uint32_t ui32Peripheral)
+{
+    I2CSlaveSim_Object *sim;
+
+    if ((ui32Peripheral & ~0xFFu) != (SYSCTL_PERIPH_I2C0 & ~0xFFu) ||
+        (ui32Peripheral & 0xFF) >= sizeof(periphBase) / sizeof(periphBase[0])) {
+        return;
+    }
+
+    sim = findSim(periphBase[ui32Peripheral & 0xFF]);
+    if (sim == NULL) {
+        return;
+    }
+
+    endTxWait(sim);
+    sim->enabled = false;
+    sim->ownAddr = 0;
+    sim->ownAddr2 = 0;
+    sim->ownAddr2En = false;
+    sim->imr = 0;
+    sim->ris = 0;
+    sim->scsr = 0;
+    sim->rxPending = false;
+    sim->txLoaded = false;
+    sim->ackOverride = false;
+    sim->ackValue = true;
+    sim->addressed = false;
+    sim->firstByte = false;
+    sim->rxFifoEnabled = false;
+    sim->rxFifoTrigger = 1;
+    sim->rxFifoHead = 0;
+    sim->rxFifoCount = 0;
+    sim->txFifoEnabled = false;
+    sim->txFifoTrigger = 0;
+    sim->txFifoHead = 0;
+    sim->txFifoCount = 0;
+}
@@ -0,0 +1,121 @@
+/*
+ *  ======== I2CSlaveSim.h ========
+ *  Host model of the Tiva I2C slave registers.
+ *
+ *  The driverlib slave API (driverlib/i2c.h) is implemented on top of this
+ *  model, so the unmodified driver runs against it. The master side is
+ *  driven through the I2CSlaveSim_start/write/read/stop functions, which
+ *  update the status and raise the instance interrupt exactly like the
+ *  peripheral would.
+ */
+
+#ifndef I2CSLAVESIM_H_
+#define I2CSLAVESIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Bytes in the receive and in the transmit FIFO */
+#define I2CSLAVESIM_FIFO_DEPTH  8
+
+typedef struct I2CSlaveSim_Object {
+    uint32_t        baseAddr;       /* Base address the driver uses */
+    int             intNum;         /* Interrupt raised through HostKernel */
+    bool            enabled;        /* I2CSCSR.DA */
+    uint8_t         ownAddr;        /* I2CSOAR */
+    uint8_t         ownAddr2;       /* I2CSOAR2 */
+    bool            ownAddr2En;     /* I2CSOAR2.OAR2EN */
+    uint32_t        imr;            /* I2CSIMR */
+    uint32_t        ris;            /* I2CSRIS */
+    uint32_t        scsr;           /* I2CSCSR status bits */
+    uint8_t         sdr;            /* I2CSDR, one register both ways */
+    bool            rxPending;      /* sdr received, not read yet; SCL held */
+    bool            txLoaded;       /* sdr written after TREQ, not sent yet */
+    bool            ackOverride;    /* I2CSACKCTL.ACKOEN */
+    bool            ackValue;       /* !I2CSACKCTL.ACKOVAL */
+    uint32_t        lineState;      /* I2CMBMON */
+    bool            addressed;      /* Current transaction is for us */
+    bool            firstByte;      /* Next received byte sets FBR */
+    /*
+     * Transmit stretching: every byte the master reads with nothing to send
+     * raises TREQ, which costs it an interrupt round trip and the time until
+     * the driver loads the byte.
+     */
+    bool            txWaiting;      /* TREQ raised, I2CSDR not loaded yet */
+    uint64_t        txWaitStartNs;
+    uint32_t        txStretches;    /* TREQs raised */
+    uint64_t        txStretchNs;    /* Time from those TREQs to the load */
+    /* Receive FIFO, which takes the bytes in place of I2CSDR when enabled */
+    bool            rxFifoEnabled;  /* I2CSlaveFIFOEnable(RX) */
+    unsigned int    rxFifoTrigger;  /* Level that raises RX_FIFO_REQ */
+    uint8_t         rxFifo[I2CSLAVESIM_FIFO_DEPTH];
+    unsigned int    rxFifoHead;
+    unsigned int    rxFifoCount;
+    /* Transmit FIFO, which feeds master reads in place of I2CSDR */
+    bool            txFifoEnabled;  /* I2CSlaveFIFOEnable(TX) */
+    unsigned int    txFifoTrigger;  /* TX_FIFO_REQ at or below this level */
+    uint8_t         txFifo[I2CSLAVESIM_FIFO_DEPTH];
+    unsigned int    txFifoHead;
+    unsigned int    txFifoCount;
+    bool            highSpeed;      /* A master code was sent, until STOP */
+    uint32_t        hsTransactions; /* Addressed in High-speed mode */
+    /*
+     * Target interrupt cost, 0 by default. The driver runs at once on the
+     * host, but an interrupt takes isrNs of CPU time, plus isrByteNs for
+     * every received byte it takes; interrupts queue behind each other.
+     * The bytes only make room in I2CSDR or the FIFO once their interrupt
+     * is over, so the bus waits for a slow ISR as it would on the target.
+     */
+    uint32_t        isrNs;
+    uint32_t        isrByteNs;
+    uint64_t        cpuFreeNs;      /* End of the last interrupt */
+    unsigned int    rxTaken;        /* Bytes taken by interrupts not over */
+    uint32_t        rxReads;        /* Bytes taken from I2CSDR or the FIFO */
+    struct I2CSlaveSim_Object *next;
+} I2CSlaveSim_Object;
+
+/* Register the model of the peripheral at baseAddr using interrupt intNum */
+extern void I2CSlaveSim_construct(I2CSlaveSim_Object *sim, uint32_t baseAddr,
+                                  int intNum);
+
+extern void I2CSlaveSim_destruct(I2CSlaveSim_Object *sim);
+
+/*
+ *  START (or repeated START) followed by the address byte. Returns true if
+ *  the slave acknowledged the address. For a read the slave is asked for
+ *  the first byte by the first I2CSlaveSim_read(). Addresses 0x04 to 0x07
+ *  are the High-speed master codes, which nobody acknowledges; the bus
+ *  stays in High-speed mode until the STOP.
+ */
+extern bool I2CSlaveSim_start(I2CSlaveSim_Object *sim, uint8_t address,
+                              bool read);
+
+/*
+ *  Master sends a byte. Returns true if it was acknowledged. The caller must
+ *  wait while I2CSlaveSim_isStretching() before sending the next byte.
+ */
+extern bool I2CSlaveSim_write(I2CSlaveSim_Object *sim, uint8_t data);
+
+/*
+ *  Master clocks in a byte. more is the master ACK (another byte follows).
+ *  With the transmit FIFO on, a byte queued in it is sent at once, and
+ *  taking it raises the FIFO request. Otherwise, or with the FIFO empty,
+ *  the byte raises TREQ and is only sent once the driver has written I2CSDR
+ *  or the FIFO after that; until then -1 is returned and the slave holds
+ *  SCL.
+ */
+extern int  I2CSlaveSim_read(I2CSlaveSim_Object *sim, bool more);
+
+/* STOP condition */
+extern void I2CSlaveSim_stop(I2CSlaveSim_Object *sim);
+
+/* Levels of SCL and SDA (I2C_MBMON_SCL | I2C_MBMON_SDA when idle) */
+extern void I2CSlaveSim_setLines(I2CSlaveSim_Object *sim, uint32_t lineState);
+
+/* True while the slave holds SCL low waiting for the driver */
+extern bool I2CSlaveSim_isStretching(I2CSlaveSim_Object *sim);
+
+/* True while a received byte has no room: the slave holds SCL after it */
+extern bool I2CSlaveSim_isRxFull(I2CSlaveSim_Object *sim);
+
+#endif /* I2CSLAVESIM_H_ */
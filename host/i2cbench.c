@@ -0,0 +1,332 @@
+/*
+ *  ======== i2cbench.c ========
+ *  Multi-instance stress benchmark: every port runs its own bus with
+ *  back-to-back master writes, all on one simulated timeline, for 1 up to
+ *  the given number of ports. Reports the aggregate throughput delivered to
+ *  the application and the host time spent per interrupt on each instance,
+ *  which should stay flat as ports are added.
+ *
+ *  Usage: i2cbench [-m blocking|pool|stream] [-n ports] [-b bitRate]
+ *                  [-l length] [-c count] [-g gap] [-H] [-i isrNs]
+ *                  [-k byteNs] [-s stretchNs]
+ *
+ *  length is the size of each master write, count the writes per port and
+ *  gap the idle bus time in microseconds between writes. Above 1 Mbit/s
+ *  every write is preceded by a High-speed master code at 400 kbit/s, and
+ *  -H opens the driver with highSpeed.
+ *
+ *  -i and -k give interrupts a target cost in simulated time, per interrupt
+ *  and per received byte (see I2CSlaveSim.h). -s is the longest the master
+ *  waits while the slave holds SCL; bytes it gives up on are counted as
+ *  overruns with those of the driver.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "I2CSlave.h"
+#include "I2CTivaSlave.h"
+#include "HostKernel.h"
+#include "HostBoard.h"
+#include "I2CSlaveReplay.h"
+
+/* One Clock tick, as configured for the target */
+#define TICK_NS     1000000ULL
+
+/* Fastest bus without a master code, Fast-mode Plus */
+#define BENCH_FMP_RATE  1000000
+
+/* Rate the master code is sent at */
+#define BENCH_FS_RATE   400000
+
+typedef struct Bench_Port {
+    I2CSlave_Handle         handle;
+    uint8_t                *capture;
+    size_t                  captureSize;
+    I2CSlaveReplay_Object   replay;
+    uint32_t                received;   /* Bytes read by the application */
+    unsigned char           streamStorage[4][64];
+    void                   *streamBufs[4];
+    uint64_t                hwiTimeNs;  /* HostKernel counters at start */
+    uint32_t                hwiCount;
+} Bench_Port;
+
+static Bench_Port ports[HostBoard_I2CSLAVECOUNT];
+
+/*
+ *  ======== makeCapture ========
+ *  count master writes of length bytes to address, gapNs apart.
+ */
+static uint8_t *makeCapture(size_t *size, uint32_t bitRate, uint8_t address,
+                            size_t length, unsigned int count, uint64_t gapNs)
+{
+    uint8_t                 data[I2CSLAVECAPTURE_DATA_MAX];
+    uint8_t                *buf;
+    uint64_t                byteNs = 9000000000ULL / bitRate;
+    uint64_t                timeNs = gapNs;
+    unsigned int            i;
+    size_t                  j;
+    I2CSlaveCapture_Writer  writer;
+
+    *size = I2CSLAVECAPTURE_HEADER_SIZE + count * (length + 48);
+    buf = malloc(*size);
+    if (buf == NULL ||
+        !I2CSlaveCapture_writerInit(&writer, buf, *size, bitRate)) {
+        free(buf);
+        return (NULL);
+    }
+
+    for (i = 0; i < count; i++) {
+        for (j = 0; j < length; j++) {
+            data[j] = (uint8_t)(i + j);
+        }
+
+        /* Master code 0000 1000, not acknowledged, then a repeated START */
+        if (bitRate > BENCH_FMP_RATE) {
+            I2CSlaveCapture_start(&writer, timeNs);
+            I2CSlaveCapture_addr(&writer, timeNs, 0x04, false);
+            timeNs += 9000000000ULL / BENCH_FS_RATE;
+        }
+
+        I2CSlaveCapture_start(&writer, timeNs);
+        I2CSlaveCapture_addr(&writer, timeNs, address, false);
+        timeNs += byteNs;
+        I2CSlaveCapture_data(&writer, timeNs, data, length);
+        timeNs += length * byteNs;
+        I2CSlaveCapture_stop(&writer, timeNs);
+        timeNs += gapNs;
+    }
+
+    *size = writer.pos;
+    return (writer.overflow ? NULL : buf);
+}
+
+/*
+ *  ======== stepEarliest ========
+ *  Plays the next bus event of the port whose event comes first.
+ */
+static bool stepEarliest(unsigned int numPorts)
+{
+    uint64_t        timeNs;
+    uint64_t        firstNs = UINT64_MAX;
+    unsigned int    i;
+    Bench_Port     *first = NULL;
+
+    for (i = 0; i < numPorts; i++) {
+        if (I2CSlaveReplay_nextTime(&ports[i].replay, &timeNs) &&
+            timeNs < firstNs) {
+            firstNs = timeNs;
+            first = &ports[i];
+        }
+    }
+
+    return (first != NULL && I2CSlaveReplay_step(&first->replay));
+}
+
+/*
+ *  ======== drain ========
+ *  The application: take everything received on every port without
+ *  blocking (readTimeout is 0).
+ */
+static void drain(unsigned int numPorts, I2CSlave_ReadMode readMode)
+{
+    int             count;
+    void           *block;
+    unsigned char   buffer[64];
+    unsigned int    i;
+
+    for (i = 0; i < numPorts; i++) {
+        do {
+            if (readMode != I2CSLAVE_MODE_BLOCKING) {
+                count = I2CSlave_readBlock(ports[i].handle, &block);
+                if (count >= 0) {
+                    I2CSlave_releaseBlock(ports[i].handle, block);
+                }
+            }
+            else {
+                count = I2CSlave_read(ports[i].handle, buffer, sizeof(buffer));
+            }
+
+            if (count > 0) {
+                ports[i].received += count;
+            }
+        } while (count > 0);
+    }
+}
+
+/*
+ *  ======== run ========
+ */
+static bool run(unsigned int numPorts, I2CSlave_Params *params,
+                uint32_t bitRate, size_t length, unsigned int count,
+                uint64_t gapNs, uint64_t stretchNs)
+{
+    int                     intNum;
+    uint32_t                hwiCount = 0;
+    uint32_t                overruns = 0;
+    uint64_t                hwiTimeNs = 0;
+    uint64_t                received = 0;
+    uint64_t                startNs;
+    uint64_t                elapsedNs;
+    unsigned int            i;
+    unsigned int            j;
+    I2CTivaSlave_Stats      stats;
+    I2CSlaveReplay_Report   report;
+
+    startNs = HostKernel_now();
+
+    for (i = 0; i < numPorts; i++) {
+        memset(&ports[i], 0, sizeof(ports[i]));
+        for (j = 0; j < 4; j++) {
+            ports[i].streamBufs[j] = ports[i].streamStorage[j];
+        }
+        params->streamBufs = ports[i].streamBufs;
+        params->streamBufCount = 4;
+        params->streamBufSize = sizeof(ports[i].streamStorage[0]);
+
+        ports[i].handle = I2CSlave_open(i, params);
+        ports[i].capture = makeCapture(&ports[i].captureSize, bitRate,
+            params->slaveAddress, length, count, gapNs);
+        if (ports[i].handle == NULL || ports[i].capture == NULL) {
+            fprintf(stderr, "Error opening port %u\n", i);
+            return (false);
+        }
+
+        /* Shift the capture onto the current timeline */
+        I2CSlaveReplay_construct(&ports[i].replay, ports[i].capture,
+            ports[i].captureSize, &hostBoardI2CSlaveSims[i],
+            ports[i].handle);
+        ports[i].replay.busFreeNs = startNs;
+        ports[i].replay.reader.timeNs = startNs;
+        if (stretchNs != UINT64_MAX) {
+            ports[i].replay.stretchLimitNs = stretchNs;
+        }
+
+        intNum = i2cTivaSlaveHWAttrs[i].intNum;
+        ports[i].hwiTimeNs = HostKernel_hwiTimeNs(intNum);
+        ports[i].hwiCount = HostKernel_hwiCount(intNum);
+    }
+
+    while (stepEarliest(numPorts)) {
+        drain(numPorts, params->readMode);
+    }
+    drain(numPorts, params->readMode);
+
+    elapsedNs = HostKernel_now() - startNs;
+
+    for (i = 0; i < numPorts; i++) {
+        intNum = i2cTivaSlaveHWAttrs[i].intNum;
+        hwiTimeNs += HostKernel_hwiTimeNs(intNum) - ports[i].hwiTimeNs;
+        hwiCount += HostKernel_hwiCount(intNum) - ports[i].hwiCount;
+        received += ports[i].received;
+
+        I2CTivaSlave_getStats(ports[i].handle, &stats);
+        I2CSlaveReplay_getReport(&ports[i].replay, &report);
+        overruns += stats.rxOverruns + report.abandoned;
+
+        I2CSlave_close(ports[i].handle);
+        free(ports[i].capture);
+    }
+
+    printf("%5u %12.1f %10.1f %10u %10u %10.1f\n", numPorts,
+        elapsedNs ? received * 1e9 / elapsedNs / 1000.0 : 0.0,
+        hwiCount ? (double)hwiTimeNs / hwiCount : 0.0,
+        (unsigned int)received, overruns,
+        hwiCount ? (double)hwiTimeNs / numPorts / 1000.0 : 0.0);
+
+    return (true);
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    int                 opt;
+    uint32_t            bitRate = 400000;
+    uint64_t            gapNs = 50000;
+    uint64_t            stretchNs = UINT64_MAX;
+    uint32_t            isrNs = 0;
+    uint32_t            isrByteNs = 0;
+    size_t              length = 16;
+    unsigned int        count = 1000;
+    unsigned int        maxPorts = HostBoard_I2CSLAVECOUNT;
+    unsigned int        n;
+    bool                usage = false;
+    I2CSlave_Params     params;
+
+    HostKernel_init(TICK_NS);
+    HostBoard_initI2CSlave();
+
+    I2CSlave_Params_init(&params);
+    params.readTimeout = 0;
+    params.writeTimeout = 100;
+
+    while ((opt = getopt(argc, argv, "m:n:b:l:c:g:Hi:k:s:")) != -1) {
+        switch (opt) {
+            case 'm':
+                params.readMode = strcmp(optarg, "pool") == 0 ?
+                    I2CSLAVE_MODE_POOL : strcmp(optarg, "stream") == 0 ?
+                    I2CSLAVE_MODE_STREAM : I2CSLAVE_MODE_BLOCKING;
+                break;
+            case 'n':
+                maxPorts = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                bitRate = strtoul(optarg, NULL, 0);
+                break;
+            case 'l':
+                length = strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                count = strtoul(optarg, NULL, 0);
+                break;
+            case 'g':
+                gapNs = strtoull(optarg, NULL, 0) * 1000;
+                break;
+            case 'H':
+                params.highSpeed = true;
+                break;
+            case 'i':
+                isrNs = strtoul(optarg, NULL, 0);
+                break;
+            case 'k':
+                isrByteNs = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                stretchNs = strtoull(optarg, NULL, 0);
+                break;
+            default:
+                usage = true;
+                break;
+        }
+    }
+
+    if (usage || optind != argc || maxPorts == 0 ||
+        maxPorts > HostBoard_I2CSLAVECOUNT || bitRate == 0 ||
+        length == 0 || length > I2CSLAVECAPTURE_DATA_MAX) {
+        fprintf(stderr, "usage: %s [-m blocking|pool|stream] [-n ports] "
+            "[-b bitRate] [-l length] [-c count] [-g gap] [-H] [-i isrNs] "
+            "[-k byteNs] [-s stretchNs]\n", argv[0]);
+        return (2);
+    }
+
+    for (n = 0; n < HostBoard_I2CSLAVECOUNT; n++) {
+        hostBoardI2CSlaveSims[n].isrNs = isrNs;
+        hostBoardI2CSlaveSims[n].isrByteNs = isrByteNs;
+    }
+
+    printf("%5s %12s %10s %10s %10s %10s\n", "ports", "kbyte/s",
+        "ns/isr", "rx bytes", "overruns", "us/port");
+    for (n = 1; n <= maxPorts; n++) {
+        if (!run(n, &params, bitRate, length, count, gapNs, stretchNs)) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,445 @@
+/*
+ *  ======== i2creplay.c ========
+ *  Replays an I2C capture (see I2CSlaveCapture.h) through the driver on the
+ *  host and reports how the driver coped with it.
+ *
+ *  The application model reads every master write and answers each master
+ *  read with the bytes of the captured device, as soon as the preceding
+ *  write was received.
+ *
+ *  Usage: i2creplay [-m blocking|pool|stream|packet] [-a address]
+ *                   [-r readTimeout] [-p writePendingTimeout] [-T] [-S] [-B]
+ *                   [-X n] [-d ticks] [-M max] [-A percentile] [-W ticks]
+ *                   [-C lifetime] [-G n] [-K isr|swi] [-H] capture.bin
+ *
+ *  -T opens the driver with frameTimestamps and also reports the driver's
+ *  own ISR to task delivery latency. -S opens it with txPrestage and -B
+ *  with rxBackpressure.
+ *
+ *  -X n makes the application use I2CSlave_transact() with n byte commands,
+ *  the reply being built from the ISR.
+ *
+ *  -d makes the application busy for the given number of ticks after each
+ *  read, like a slow consumer. The bus keeps running meanwhile.
+ *
+ *  -A adapts the write pending timeout to the given percentile of the
+ *  application's response time, starting from -p.
+ *
+ *  -W opens the driver with a bus watchdog of the given period, and -C with
+ *  a reply cache of the given lifetime in ticks.
+ *
+ *  -G opens the driver with generalCall, and n more instances that only
+ *  subscribe to the general calls it receives; each of them reads the
+ *  frames without blocking.
+ *
+ *  -K passes the received bytes through two sink stages that count them on
+ *  their way to the read mode: the first in the ISR, the second in the ISR
+ *  or in a Swi.
+ *
+ *  -H opens the driver with highSpeed, so received bytes are taken from the
+ *  receive FIFO in bursts.
+ *
+ *  In packet mode the first byte of every packet is the number of bytes
+ *  that follow it; -M sets the largest packet accepted.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "I2CSlave.h"
+#include "I2CTivaSlave.h"
+#include "HostKernel.h"
+#include "HostBoard.h"
+#include "I2CSlaveReplay.h"
+
+/* One Clock tick, as configured for the target */
+#define TICK_NS     1000000ULL
+
+/* Buffers of the stream mode */
+static unsigned char streamStorage[4][32];
+static void * const streamBufs[4] = {
+    streamStorage[0], streamStorage[1], streamStorage[2], streamStorage[3]
+};
+
+/* Replay the transact responder answers from */
+static I2CSlaveReplay_Object *transactReplay;
+
+/* Instances subscribed to general calls and the frames each one read */
+static I2CSlave_Handle subscribers[HostBoard_I2CSLAVECOUNT];
+static uint32_t subscriberFrames[HostBoard_I2CSLAVECOUNT];
+static unsigned int subscriberCount;
+
+/* I2CSlave_transact() calls that returned a reply count, and errors */
+static uint32_t transactOk;
+static uint32_t transactErrors;
+
+/* What went through the sink stages */
+static uint32_t sinkBytes;
+static uint32_t sinkWrites;
+
+/*
+ *  ======== countBytes ========
+ *  Sink stage, passes every byte on.
+ */
+static size_t countBytes(I2CSlave_Handle handle, void *arg,
+                         unsigned char *data, size_t count, bool end)
+{
+    sinkBytes += count;
+
+    return (count);
+}
+
+/*
+ *  ======== countWrites ========
+ *  Sink stage, passes every byte on.
+ */
+static size_t countWrites(I2CSlave_Handle handle, void *arg,
+                          unsigned char *data, size_t count, bool end)
+{
+    if (end) {
+        sinkWrites++;
+    }
+
+    return (count);
+}
+
+static I2CSlave_Sink sinks[2] = {
+    {countBytes, NULL, I2CSLAVE_SINK_ISR},
+    {countWrites, NULL, I2CSLAVE_SINK_ISR}
+};
+
+/*
+ *  ======== loadFile ========
+ */
+static uint8_t *loadFile(const char *path, size_t *size)
+{
+    FILE       *file;
+    uint8_t    *buf;
+    long        length;
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return (NULL);
+    }
+
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    buf = malloc(length > 0 ? length : 1);
+    if (buf != NULL && fread(buf, 1, length, file) != (size_t)length) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(file);
+
+    *size = length;
+    return (buf);
+}
+
+/*
+ *  ======== transactResponder ========
+ *  Runs in the ISR once the command is in; replies like the captured device.
+ */
+static size_t transactResponder(I2CSlave_Handle handle,
+                                const unsigned char *cmd, size_t cmdSize,
+                                unsigned char *reply, size_t replySize)
+{
+    I2CSlaveReplay_markDelivered(transactReplay, cmdSize);
+
+    return (I2CSlaveReplay_nextReply(transactReplay, reply, replySize));
+}
+
+/*
+ *  ======== drainBroadcasts ========
+ *  Every subscriber takes the general call frames waiting for it.
+ */
+static void drainBroadcasts(void)
+{
+    unsigned int    i;
+    void           *frame;
+
+    for (i = 0; i < subscriberCount; i++) {
+        while (I2CSlave_readBroadcast(subscribers[i], &frame) >= 0) {
+            subscriberFrames[i]++;
+            I2CSlave_releaseBroadcast(subscribers[i], frame);
+        }
+    }
+}
+
+/*
+ *  ======== printReport ========
+ */
+static void printReport(const I2CSlaveReplay_Report *report,
+                        const I2CTivaSlave_Stats *stats)
+{
+    unsigned int    i;
+
+    printf("transactions     %u\n", report->transactions);
+    printf("master writes    %u (%u bytes)\n", report->writeMessages,
+        report->bytesWritten);
+    printf("master reads     %u (%u bytes)\n", report->readMessages,
+        report->bytesRead);
+    printf("delivered        %u\n", report->delivered);
+    printf("answered cached  %u\n", report->cached);
+    if (report->delivered) {
+        printf("latency us       min %.1f avg %.1f max %.1f\n",
+            report->latencyMinNs / 1000.0,
+            report->latencySumNs / 1000.0 / report->delivered,
+            report->latencyMaxNs / 1000.0);
+    }
+    printf("rx overruns      %u\n", report->rxOverruns);
+    printf("rx holds         %u\n", stats->rxHolds);
+    printf("rx rejected      %u\n", stats->rxRejected);
+    printf("tx stuffed       %u\n", report->txStuffed);
+    printf("tx discarded     %u\n", report->txDiscarded);
+    printf("tx pend timeout  %u ticks (%u samples)\n", stats->txPendTimeout,
+        stats->txPendSamples);
+    printf("read mismatches  %u\n", report->mismatches);
+    printf("nacks            %u\n", report->nacks);
+    printf("stretches        %u (total %.1f us, max %.1f us)\n",
+        report->stretches, report->stretchNs / 1000.0,
+        report->stretchMaxNs / 1000.0);
+    printf("tx stretches     %u (total %.1f us)\n", report->txStretches,
+        report->txStretchNs / 1000.0);
+    printf("abandoned bytes  %u\n", report->abandoned);
+    printf("cache hits       %u\n", stats->cacheHits);
+    printf("bus recoveries   %u (last %u ticks, max %u ticks)\n",
+        stats->busRecoveries, stats->busRecoveryLast, stats->busRecoveryMax);
+    if (subscriberCount) {
+        printf("general calls    %u (%u frames, %u bytes dropped)\n",
+            report->generalCalls, stats->bcastFrames, stats->bcastOverruns);
+        printf("frames read      %u", subscriberFrames[0]);
+        for (i = 1; i < subscriberCount; i++) {
+            printf(" %u", subscriberFrames[i]);
+        }
+        printf("\n");
+    }
+    if (stats->latencyCount) {
+        printf("isr to task us   min %.1f avg %.1f max %.1f (%u reads)\n",
+            stats->latencyMin * 1e6 / HOSTBOARD_TIMESTAMP_HZ,
+            stats->latencySum * 1e6 / HOSTBOARD_TIMESTAMP_HZ /
+                stats->latencyCount,
+            stats->latencyMax * 1e6 / HOSTBOARD_TIMESTAMP_HZ,
+            stats->latencyCount);
+    }
+    if (stats->stampDrops) {
+        printf("stamp drops      %u\n", stats->stampDrops);
+    }
+    if (transactOk || transactErrors) {
+        printf("transacts        %u ok, %u errors\n", transactOk,
+            transactErrors);
+    }
+    if (stats->rxBursts) {
+        printf("rx bursts        %u (%.1f bytes each)\n", stats->rxBursts,
+            (double)stats->rxBytes / stats->rxBursts);
+    }
+    if (stats->sinkBatches) {
+        printf("sink stages      %u batches, %u bytes, %u writes\n",
+            stats->sinkBatches, sinkBytes, sinkWrites);
+    }
+}
+
+/*
+ *  ======== main ========
+ */
+int main(int argc, char *argv[])
+{
+    int                     opt;
+    int                     count;
+    size_t                  reply;
+    size_t                  size;
+    size_t                  transactLen = 0;
+    unsigned int            workTicks = 0;
+    unsigned int            i;
+    Semaphore_Struct        workSem;
+    uint32_t                timestamp;
+    uint8_t                *capture;
+    void                   *block;
+    unsigned char           buffer[I2CSLAVECAPTURE_DATA_MAX];
+    I2CSlave_Params         params;
+    I2CSlave_Params         subscriberParams;
+    I2CSlave_Handle         handle;
+    I2CSlaveReplay_Object   replay;
+    I2CSlaveReplay_Report   report;
+    I2CTivaSlave_Stats      stats;
+
+    HostKernel_init(TICK_NS);
+    HostBoard_initI2CSlave();
+
+    I2CSlave_Params_init(&params);
+    params.readTimeout = 1;
+    params.writeTimeout = 100;
+    params.writePendingTimeout = 40;
+    params.streamBufs = streamBufs;
+    params.streamBufCount = 4;
+    params.streamBufSize = sizeof(streamStorage[0]);
+
+    while ((opt = getopt(argc, argv, "m:a:r:p:TSBX:d:M:A:W:C:G:K:H")) != -1) {
+        switch (opt) {
+            case 'm':
+                params.readMode = strcmp(optarg, "pool") == 0 ?
+                    I2CSLAVE_MODE_POOL : strcmp(optarg, "stream") == 0 ?
+                    I2CSLAVE_MODE_STREAM : strcmp(optarg, "packet") == 0 ?
+                    I2CSLAVE_MODE_PACKET : I2CSLAVE_MODE_BLOCKING;
+                break;
+            case 'a':
+                params.slaveAddress = strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                params.readTimeout = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                params.writePendingTimeout = strtoul(optarg, NULL, 0);
+                break;
+            case 'T':
+                params.frameTimestamps = true;
+                break;
+            case 'S':
+                params.txPrestage = true;
+                break;
+            case 'B':
+                params.rxBackpressure = true;
+                break;
+            case 'd':
+                workTicks = strtoul(optarg, NULL, 0);
+                break;
+            case 'X':
+                transactLen = strtoul(optarg, NULL, 0);
+                break;
+            case 'M':
+                params.packetMaxSize = strtoul(optarg, NULL, 0);
+                break;
+            case 'A':
+                params.writePendingPercentile = strtoul(optarg, NULL, 0);
+                break;
+            case 'W':
+                params.busWatchdog = strtoul(optarg, NULL, 0);
+                break;
+            case 'C':
+                params.replyCacheLifetime = strtoul(optarg, NULL, 0);
+                break;
+            case 'G':
+                params.generalCall = true;
+                subscriberCount = strtoul(optarg, NULL, 0);
+                break;
+            case 'K':
+                if (strcmp(optarg, "swi") == 0) {
+                    sinks[1].level = I2CSLAVE_SINK_SWI;
+                }
+                params.sinks = sinks;
+                params.sinkCount = 2;
+                break;
+            case 'H':
+                params.highSpeed = true;
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+
+    if (optind != argc - 1 || subscriberCount >= HostBoard_I2CSLAVECOUNT) {
+        fprintf(stderr, "usage: %s [-m blocking|pool|stream|packet] "
+            "[-a address] [-r readTimeout] [-p writePendingTimeout] [-T] "
+            "[-S] [-B] [-X n] [-d ticks] [-M max] [-A percentile] "
+            "[-W ticks] [-C lifetime] [-G n] [-K isr|swi] [-H] capture.bin\n",
+            argv[0]);
+        return (2);
+    }
+
+    capture = loadFile(argv[optind], &size);
+    if (capture == NULL) {
+        perror(argv[optind]);
+        return (1);
+    }
+
+    handle = I2CSlave_open(HostBoard_I2CSLAVE5, &params);
+    if (handle == NULL) {
+        fprintf(stderr, "Error opening the I2CSlave\n");
+        return (1);
+    }
+
+    /* The other ports only take part in the fan-out, their buses are idle */
+    I2CSlave_Params_init(&subscriberParams);
+    subscriberParams.readTimeout = 0;
+    subscriberParams.generalCallSubscribe = true;
+    for (i = 0; i < subscriberCount; i++) {
+        subscribers[i] = I2CSlave_open(HostBoard_I2CSLAVE5 + 1 + i,
+            &subscriberParams);
+        if (subscribers[i] == NULL) {
+            fprintf(stderr, "Error opening subscriber %u\n", i);
+            return (1);
+        }
+    }
+
+    if (!I2CSlaveReplay_construct(&replay, capture, size,
+            &hostBoardI2CSlaveSims[HostBoard_I2CSLAVE5], handle)) {
+        fprintf(stderr, "%s: not a valid capture\n", argv[optind]);
+        return (1);
+    }
+    HostKernel_setIdleFxn(I2CSlaveReplay_idle, &replay);
+    transactReplay = &replay;
+    Semaphore_construct(&workSem, 0, NULL);
+
+    while (!I2CSlaveReplay_done(&replay)) {
+        if (transactLen) {
+            if (I2CSlave_transact(handle, buffer, transactLen,
+                    transactResponder) >= 0) {
+                transactOk++;
+            }
+            else {
+                transactErrors++;
+            }
+            continue;
+        }
+
+        if (params.readMode == I2CSLAVE_MODE_POOL ||
+            params.readMode == I2CSLAVE_MODE_STREAM) {
+            count = I2CSlave_readBlock(handle, &block);
+            if (count >= 0) {
+                I2CSlave_releaseBlock(handle, block);
+            }
+        }
+        else {
+            count = I2CSlave_readTimestamp(handle, buffer, sizeof(buffer),
+                &timestamp);
+        }
+
+        drainBroadcasts();
+
+        /* Busy: a pend that is never posted lets the bus run meanwhile */
+        if (workTicks) {
+            Semaphore_pend(Semaphore_handle(&workSem), workTicks);
+        }
+
+        if (count > 0) {
+            I2CSlaveReplay_markDelivered(&replay, count);
+
+            reply = I2CSlaveReplay_nextReply(&replay, buffer, sizeof(buffer));
+            if (reply) {
+                I2CSlave_write(handle, buffer, reply);
+            }
+        }
+    }
+
+    drainBroadcasts();
+    I2CSlaveReplay_getReport(&replay, &report);
+    I2CTivaSlave_getStats(handle, &stats);
+    printReport(&report, &stats);
+
+    I2CSlave_close(handle);
+    for (i = 0; i < subscriberCount; i++) {
+        I2CSlave_close(subscribers[i]);
+    }
+    free(capture);
+
+    return (0);
+}
@@ -0,0 +1,68 @@
+#!/bin/sh
+#
+#  ======== i2csize.sh ========
+#  Flash and RAM of I2CTivaSlave.c for a set of I2CTivaSlaveConfig.h
+#  configurations: the full driver, I2CTIVASLAVE_MINIMAL and every argument,
+#  each of which is one set of -D options.
+#
+#  Usage, from the repository root:
+#      host/i2csize.sh ["-DI2CTIVASLAVE_MINIMAL -DI2CTIVASLAVE_USE_POOL=1" ...]
+#
+#  text, data and bss are those of the driver object file; object is
+#  sizeof(I2CTivaSlave_Object), the RAM taken by each instance. pool and
+#  cache are the pool blocks and reply cache entries the board file keeps
+#  for each port, broadcast the general call frames all ports share; they
+#  are taken from host/HostBoard.c, which has the dimensions of
+#  EK_TM4C1294XL.c, and are 0 when the feature is left out. By default
+#  the driver is built against the host stand-in headers, whose kernel
+#  objects are not the size of the SYS/BIOS ones. For target numbers set
+#  CC, CFLAGS (with the TI-RTOS and TivaWare include paths), SIZE and NM,
+#  e.g. CC=arm-none-eabi-gcc SIZE=arm-none-eabi-size NM=arm-none-eabi-nm.
+#
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--Os -I. -Ihost -Ihost/include}
+SIZE=${SIZE:-size}
+NM=${NM:-nm}
+
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+cat > "$tmp/probe.c" <<PROBE
+#include <stdint.h>
+#include <stdbool.h>
+#include "I2CSlave.h"
+#include "I2CTivaSlave.h"
+
+I2CTivaSlave_Object i2cTivaSlaveSizeProbe;
+PROBE
+
+# Size of a board file symbol, 0 if it is left out
+symsize() {
+    size=$(awk -v sym="$1" '$4 == sym { print $2 }' "$tmp/board.sym")
+    echo $(( 0x${size:-0} ))
+}
+
+printf "%-60s %8s %8s %8s %8s %8s %8s %8s\n" "configuration" \
+    "text" "data" "bss" "object" "pool" "cache" "broadcast"
+
+for config in "" "-DI2CTIVASLAVE_MINIMAL" "$@"; do
+    $CC $CFLAGS $config -c I2CTivaSlave.c -o "$tmp/driver.o" &&
+    $CC $CFLAGS $config -fno-common -c "$tmp/probe.c" -o "$tmp/probe.o" &&
+    $CC $CFLAGS $config -fno-common -c host/HostBoard.c -o "$tmp/board.o" ||
+        exit 1
+
+    sizes=$($SIZE "$tmp/driver.o" | awk 'END { print $1, $2, $3 }')
+    object=$($NM -S "$tmp/probe.o" |
+        awk '/i2cTivaSlaveSizeProbe/ { print $2 }')
+
+    $NM -S "$tmp/board.o" > "$tmp/board.sym"
+    ports=$(( $(symsize i2cTivaSlaveObjects) / 0x$object ))
+    pool=$(( ($(symsize i2cTivaSlavePoolBlocks) +
+        $(symsize i2cTivaSlavePoolBuffer)) / ports ))
+    cache=$(( $(symsize i2cTivaSlaveReplyCache) / ports ))
+    broadcast=$(symsize i2cTivaSlaveBroadcast)
+
+    printf "%-60s %8s %8s %8s %8d %8d %8d %8d\n" "${config:-full}" $sizes \
+        "0x$object" $pool $cache $broadcast
+done
@@ -0,0 +1,71 @@
+/*
+ *  ======== driverlib/i2c.h ========
+ *  Slave side of the TivaWare I2C API, implemented on the host by the
+ *  register model in I2CSlaveSim.c.
+ */
+
+#ifndef HOST_DRIVERLIB_I2C_H_
+#define HOST_DRIVERLIB_I2C_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_SLAVE_ACT_NONE          0
+#define I2C_SLAVE_ACT_RREQ          0x00000001
+#define I2C_SLAVE_ACT_TREQ          0x00000002
+#define I2C_SLAVE_ACT_RREQ_FBR      0x00000005
+#define I2C_SLAVE_ACT_OWN2SEL       0x00000008
+
+#define I2C_SLAVE_INT_RX_FIFO_FULL  0x00000100
+#define I2C_SLAVE_INT_TX_FIFO_EMPTY 0x00000080
+#define I2C_SLAVE_INT_RX_FIFO_REQ   0x00000040
+#define I2C_SLAVE_INT_TX_FIFO_REQ   0x00000020
+#define I2C_SLAVE_INT_STOP          0x00000004
+#define I2C_SLAVE_INT_START         0x00000002
+#define I2C_SLAVE_INT_DATA          0x00000001
+
+#define I2C_SLAVE_TX_FIFO_ENABLE    0x00000002
+#define I2C_SLAVE_RX_FIFO_ENABLE    0x00000004
+
+#define I2C_FIFO_CFG_TX_SLAVE       0x00008000
+#define I2C_FIFO_CFG_TX_NO_TRIG     0x00000000
+#define I2C_FIFO_CFG_RX_SLAVE       0x80000000
+#define I2C_FIFO_CFG_RX_TRIG_1      0x00010000
+#define I2C_FIFO_CFG_RX_TRIG_2      0x00020000
+#define I2C_FIFO_CFG_RX_TRIG_4      0x00040000
+#define I2C_FIFO_CFG_RX_TRIG_6      0x00060000
+
+#define I2C_FIFO_RX_BELOW_TRIG_LEVEL 0x00040000
+#define I2C_FIFO_RX_FULL            0x00020000
+#define I2C_FIFO_RX_EMPTY           0x00010000
+#define I2C_FIFO_TX_BELOW_TRIG_LEVEL 0x00000004
+#define I2C_FIFO_TX_FULL            0x00000002
+#define I2C_FIFO_TX_EMPTY           0x00000001
+
+extern void     I2CSlaveInit(uint32_t ui32Base, uint8_t ui8SlaveAddr);
+extern void     I2CSlaveAddressSet(uint32_t ui32Base, uint8_t ui8AddrNum,
+                                   uint8_t ui8SlaveAddr);
+extern void     I2CSlaveEnable(uint32_t ui32Base);
+extern void     I2CSlaveDisable(uint32_t ui32Base);
+extern uint32_t I2CSlaveStatus(uint32_t ui32Base);
+extern void     I2CSlaveDataPut(uint32_t ui32Base, uint8_t ui8Data);
+extern uint32_t I2CSlaveDataGet(uint32_t ui32Base);
+extern void     I2CSlaveIntEnableEx(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void     I2CSlaveIntDisableEx(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void     I2CSlaveIntDisable(uint32_t ui32Base);
+extern uint32_t I2CSlaveIntStatusEx(uint32_t ui32Base, bool bMasked);
+extern void     I2CSlaveIntClearEx(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void     I2CSlaveFIFOEnable(uint32_t ui32Base, uint32_t ui32Config);
+extern void     I2CSlaveFIFODisable(uint32_t ui32Base);
+extern void     I2CSlaveACKOverride(uint32_t ui32Base, bool bEnable);
+extern void     I2CSlaveACKValueSet(uint32_t ui32Base, bool bACK);
+extern void     I2CRxFIFOConfigSet(uint32_t ui32Base, uint32_t ui32Config);
+extern void     I2CRxFIFOFlush(uint32_t ui32Base);
+extern void     I2CTxFIFOConfigSet(uint32_t ui32Base, uint32_t ui32Config);
+extern void     I2CTxFIFOFlush(uint32_t ui32Base);
+extern void     I2CFIFODataPut(uint32_t ui32Base, uint8_t ui8Data);
+extern uint32_t I2CFIFOStatus(uint32_t ui32Base);
+extern uint32_t I2CFIFODataGetNonBlocking(uint32_t ui32Base, uint8_t *pui8Data);
+extern uint32_t I2CMasterLineStateGet(uint32_t ui32Base);
+
+#endif /* HOST_DRIVERLIB_I2C_H_ */
@@ -0,0 +1,23 @@
+/*
+ *  ======== driverlib/sysctl.h ========
+ */
+
+#ifndef HOST_DRIVERLIB_SYSCTL_H_
+#define HOST_DRIVERLIB_SYSCTL_H_
+
+#include <stdint.h>
+
+#define SYSCTL_PERIPH_I2C0      0xf0002000
+#define SYSCTL_PERIPH_I2C1      0xf0002001
+#define SYSCTL_PERIPH_I2C2      0xf0002002
+#define SYSCTL_PERIPH_I2C3      0xf0002003
+#define SYSCTL_PERIPH_I2C4      0xf0002004
+#define SYSCTL_PERIPH_I2C5      0xf0002005
+#define SYSCTL_PERIPH_I2C6      0xf0002006
+#define SYSCTL_PERIPH_I2C7      0xf0002007
+#define SYSCTL_PERIPH_I2C8      0xf0002008
+#define SYSCTL_PERIPH_I2C9      0xf0002009
+
+extern void     SysCtlPeripheralReset(uint32_t ui32Peripheral);
+
+#endif /* HOST_DRIVERLIB_SYSCTL_H_ */
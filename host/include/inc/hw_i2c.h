@@ -0,0 +1,17 @@
+/*
+ *  ======== inc/hw_i2c.h ========
+ *  Slave register bits used by the driver and modelled on the host.
+ */
+
+#ifndef HOST_INC_HW_I2C_H_
+#define HOST_INC_HW_I2C_H_
+
+#define I2C_SCSR_RREQ           0x00000001  /* Receive Request */
+#define I2C_SCSR_TREQ           0x00000002  /* Transmit Request */
+#define I2C_SCSR_FBR            0x00000004  /* First Byte Received */
+#define I2C_SCSR_OAR2SEL        0x00000008  /* OAR2 Address Matched */
+
+#define I2C_MBMON_SCL           0x00000001  /* I2C SCL Status */
+#define I2C_MBMON_SDA           0x00000002  /* I2C SDA Status */
+
+#endif /* HOST_INC_HW_I2C_H_ */
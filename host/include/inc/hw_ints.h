@@ -0,0 +1,21 @@
+/*
+ *  ======== inc/hw_ints.h ========
+ */
+
+#ifndef HOST_INC_HW_INTS_H_
+#define HOST_INC_HW_INTS_H_
+
+#define INT_I2C0                24
+#define INT_I2C1                53
+#define INT_I2C2                84
+#define INT_I2C3                85
+#define INT_I2C4                125
+#define INT_I2C5                126
+#define INT_I2C6                127
+#define INT_I2C7                128
+#define INT_I2C8                129
+#define INT_I2C9                130
+
+#define NUM_INTERRUPTS          131
+
+#endif /* HOST_INC_HW_INTS_H_ */
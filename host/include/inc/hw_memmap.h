@@ -0,0 +1,21 @@
+/*
+ *  ======== inc/hw_memmap.h ========
+ *  Base addresses only identify an instance of the register model on the
+ *  host; they are never dereferenced.
+ */
+
+#ifndef HOST_INC_HW_MEMMAP_H_
+#define HOST_INC_HW_MEMMAP_H_
+
+#define I2C0_BASE               0x40020000
+#define I2C1_BASE               0x40021000
+#define I2C2_BASE               0x40022000
+#define I2C3_BASE               0x40023000
+#define I2C4_BASE               0x400C0000
+#define I2C5_BASE               0x400C1000
+#define I2C6_BASE               0x400C2000
+#define I2C7_BASE               0x400C3000
+#define I2C8_BASE               0x400B8000
+#define I2C9_BASE               0x400B9000
+
+#endif /* HOST_INC_HW_MEMMAP_H_ */
@@ -0,0 +1,13 @@
+/*
+ *  ======== inc/hw_types.h ========
+ */
+
+#ifndef HOST_INC_HW_TYPES_H_
+#define HOST_INC_HW_TYPES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HWREG(x)                (*((volatile uint32_t *)(uintptr_t)(x)))
+
+#endif /* HOST_INC_HW_TYPES_H_ */
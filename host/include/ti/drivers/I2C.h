@@ -0,0 +1,9 @@
+/*
+ *  ======== ti/drivers/I2C.h ========
+ *  Nothing from the master driver is used by the slave driver on the host.
+ */
+
+#ifndef HOST_TI_DRIVERS_I2C_H_
+#define HOST_TI_DRIVERS_I2C_H_
+
+#endif /* HOST_TI_DRIVERS_I2C_H_ */
@@ -0,0 +1,31 @@
+/*
+ *  ======== ti/drivers/utils/RingBuf.h ========
+ *  Same layout and semantics as the TI-RTOS RingBuf utility.
+ */
+
+#ifndef HOST_TI_DRIVERS_UTILS_RINGBUF_H_
+#define HOST_TI_DRIVERS_UTILS_RINGBUF_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct RingBuf_Object {
+    unsigned char      *buffer;
+    size_t              length;
+    size_t              count;
+    size_t              head;
+    size_t              tail;
+    size_t              maxCount;
+} RingBuf_Object, *RingBuf_Handle;
+
+extern void RingBuf_construct(RingBuf_Handle object, unsigned char *bufferPtr,
+                              size_t bufferSize);
+extern int  RingBuf_get(RingBuf_Handle object, unsigned char *data);
+extern int  RingBuf_getCount(RingBuf_Handle object);
+extern bool RingBuf_isFull(RingBuf_Handle object);
+extern int  RingBuf_getMaxCount(RingBuf_Handle object);
+extern int  RingBuf_peek(RingBuf_Handle object, unsigned char *data);
+extern int  RingBuf_put(RingBuf_Handle object, unsigned char data);
+
+#endif /* HOST_TI_DRIVERS_UTILS_RINGBUF_H_ */
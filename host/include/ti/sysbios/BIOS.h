@@ -0,0 +1,13 @@
+/*
+ *  ======== ti/sysbios/BIOS.h ========
+ */
+
+#ifndef HOST_TI_SYSBIOS_BIOS_H_
+#define HOST_TI_SYSBIOS_BIOS_H_
+
+#include <xdc/std.h>
+
+#define BIOS_NO_WAIT            0
+#define BIOS_WAIT_FOREVER       (~0U)
+
+#endif /* HOST_TI_SYSBIOS_BIOS_H_ */
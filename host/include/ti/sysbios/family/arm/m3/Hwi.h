@@ -0,0 +1,51 @@
+/*
+ *  ======== ti/sysbios/family/arm/m3/Hwi.h ========
+ *  Host Hwi module. Interrupts are raised synchronously by the register model
+ *  through HostKernel_raise().
+ */
+
+#ifndef HOST_TI_SYSBIOS_FAMILY_ARM_M3_HWI_H_
+#define HOST_TI_SYSBIOS_FAMILY_ARM_M3_HWI_H_
+
+#include <xdc/std.h>
+
+typedef void (*ti_sysbios_family_arm_m3_Hwi_FuncPtr)(UArg arg);
+
+typedef struct ti_sysbios_family_arm_m3_Hwi_Params {
+    UArg            arg;
+    int             priority;
+} ti_sysbios_family_arm_m3_Hwi_Params;
+
+typedef struct ti_sysbios_family_arm_m3_Hwi_Struct {
+    int                                     intNum;
+    ti_sysbios_family_arm_m3_Hwi_FuncPtr    fxn;
+    UArg                                    arg;
+} ti_sysbios_family_arm_m3_Hwi_Struct;
+
+extern void ti_sysbios_family_arm_m3_Hwi_Params_init(
+    ti_sysbios_family_arm_m3_Hwi_Params *params);
+extern void ti_sysbios_family_arm_m3_Hwi_construct(
+    ti_sysbios_family_arm_m3_Hwi_Struct *hwi, int intNum,
+    ti_sysbios_family_arm_m3_Hwi_FuncPtr fxn,
+    const ti_sysbios_family_arm_m3_Hwi_Params *params, void *eb);
+extern void ti_sysbios_family_arm_m3_Hwi_destruct(
+    ti_sysbios_family_arm_m3_Hwi_Struct *hwi);
+extern unsigned int ti_sysbios_family_arm_m3_Hwi_disable(void);
+extern void ti_sysbios_family_arm_m3_Hwi_restore(unsigned int key);
+
+#endif /* HOST_TI_SYSBIOS_FAMILY_ARM_M3_HWI_H_ */
+
+#if !defined(ti_sysbios_family_arm_m3_Hwi__nolocalnames) && \
+    !defined(HOST_TI_SYSBIOS_FAMILY_ARM_M3_HWI_LOCALNAMES_)
+#define HOST_TI_SYSBIOS_FAMILY_ARM_M3_HWI_LOCALNAMES_
+
+#define Hwi_FuncPtr             ti_sysbios_family_arm_m3_Hwi_FuncPtr
+#define Hwi_Params              ti_sysbios_family_arm_m3_Hwi_Params
+#define Hwi_Struct              ti_sysbios_family_arm_m3_Hwi_Struct
+#define Hwi_Params_init         ti_sysbios_family_arm_m3_Hwi_Params_init
+#define Hwi_construct           ti_sysbios_family_arm_m3_Hwi_construct
+#define Hwi_destruct            ti_sysbios_family_arm_m3_Hwi_destruct
+#define Hwi_disable             ti_sysbios_family_arm_m3_Hwi_disable
+#define Hwi_restore             ti_sysbios_family_arm_m3_Hwi_restore
+
+#endif
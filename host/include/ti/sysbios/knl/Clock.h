@@ -0,0 +1,43 @@
+/*
+ *  ======== ti/sysbios/knl/Clock.h ========
+ *  Host Clock module. Time only moves when the replay engine advances it;
+ *  expired clock functions run from HostKernel_advance().
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_CLOCK_H_
+#define HOST_TI_SYSBIOS_KNL_CLOCK_H_
+
+#include <xdc/std.h>
+
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct Clock_Params {
+    UInt32          period;
+    Bool            startFlag;
+    UArg            arg;
+} Clock_Params;
+
+typedef struct Clock_Struct {
+    Clock_FuncPtr   fxn;
+    UArg            arg;
+    UInt32          timeout;
+    UInt32          period;
+    UInt32          deadline;
+    bool            active;
+    struct Clock_Struct *next;
+} Clock_Struct, *Clock_Handle;
+
+#define Clock_handle(s)         ((Clock_Handle)(s))
+
+extern void     Clock_Params_init(Clock_Params *params);
+extern void     Clock_construct(Clock_Struct *clk, Clock_FuncPtr fxn,
+                                UInt32 timeout, const Clock_Params *params);
+extern void     Clock_destruct(Clock_Struct *clk);
+extern void     Clock_start(Clock_Handle clk);
+extern void     Clock_stop(Clock_Handle clk);
+extern bool     Clock_isActive(Clock_Handle clk);
+extern void     Clock_setTimeout(Clock_Handle clk, UInt32 timeout);
+extern void     Clock_setPeriod(Clock_Handle clk, UInt32 period);
+extern UInt32   Clock_getTicks(void);
+
+#endif /* HOST_TI_SYSBIOS_KNL_CLOCK_H_ */
@@ -0,0 +1,29 @@
+/*
+ *  ======== ti/sysbios/knl/Queue.h ========
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_QUEUE_H_
+#define HOST_TI_SYSBIOS_KNL_QUEUE_H_
+
+#include <xdc/std.h>
+
+typedef struct Queue_Elem {
+    struct Queue_Elem *next;
+    struct Queue_Elem *prev;
+} Queue_Elem;
+
+typedef struct Queue_Struct {
+    Queue_Elem      elem;
+} Queue_Struct, *Queue_Handle;
+
+#define Queue_handle(s)         ((Queue_Handle)(s))
+
+extern void     Queue_construct(Queue_Struct *queue, void *params);
+extern void     Queue_destruct(Queue_Struct *queue);
+extern bool     Queue_empty(Queue_Handle queue);
+extern void    *Queue_get(Queue_Handle queue);
+extern void     Queue_put(Queue_Handle queue, Queue_Elem *elem);
+extern void     Queue_enqueue(Queue_Handle queue, Queue_Elem *elem);
+extern void    *Queue_dequeue(Queue_Handle queue);
+
+#endif /* HOST_TI_SYSBIOS_KNL_QUEUE_H_ */
@@ -0,0 +1,37 @@
+/*
+ *  ======== ti/sysbios/knl/Semaphore.h ========
+ *  Host Semaphore module. A pend on an unavailable semaphore runs the host
+ *  idle function (normally the replay engine) until the semaphore is posted,
+ *  the timeout expires or the idle function has nothing left to do.
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_
+#define HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_
+
+#include <xdc/std.h>
+
+typedef enum Semaphore_Mode {
+    Semaphore_Mode_COUNTING,
+    Semaphore_Mode_BINARY
+} Semaphore_Mode;
+
+typedef struct Semaphore_Params {
+    Semaphore_Mode  mode;
+} Semaphore_Params;
+
+typedef struct Semaphore_Struct {
+    Semaphore_Mode  mode;
+    unsigned int    count;
+} Semaphore_Struct, *Semaphore_Handle;
+
+#define Semaphore_handle(s)     ((Semaphore_Handle)(s))
+
+extern void     Semaphore_Params_init(Semaphore_Params *params);
+extern void     Semaphore_construct(Semaphore_Struct *sem, int count,
+                                    const Semaphore_Params *params);
+extern void     Semaphore_destruct(Semaphore_Struct *sem);
+extern bool     Semaphore_pend(Semaphore_Handle sem, UInt32 timeout);
+extern void     Semaphore_post(Semaphore_Handle sem);
+extern int      Semaphore_getCount(Semaphore_Handle sem);
+
+#endif /* HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_ */
@@ -0,0 +1,37 @@
+/*
+ *  ======== ti/sysbios/knl/Swi.h ========
+ *  Host Swi module. A Swi posted from a Hwi runs when the Hwi returns, one
+ *  posted from the task runs at once, as on a target where every Swi has
+ *  priority over the task.
+ */
+
+#ifndef HOST_TI_SYSBIOS_KNL_SWI_H_
+#define HOST_TI_SYSBIOS_KNL_SWI_H_
+
+#include <xdc/std.h>
+
+typedef void (*Swi_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct Swi_Params {
+    UArg            arg0;
+    UArg            arg1;
+    UInt            priority;
+} Swi_Params;
+
+typedef struct Swi_Struct {
+    Swi_FuncPtr     fxn;
+    UArg            arg0;
+    UArg            arg1;
+    bool            posted;
+    struct Swi_Struct *next;
+} Swi_Struct, *Swi_Handle;
+
+#define Swi_handle(s)           ((Swi_Handle)(s))
+
+extern void     Swi_Params_init(Swi_Params *params);
+extern void     Swi_construct(Swi_Struct *swi, Swi_FuncPtr fxn,
+                              const Swi_Params *params, void *eb);
+extern void     Swi_destruct(Swi_Struct *swi);
+extern void     Swi_post(Swi_Handle swi);
+
+#endif /* HOST_TI_SYSBIOS_KNL_SWI_H_ */
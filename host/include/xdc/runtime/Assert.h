@@ -0,0 +1,12 @@
+/*
+ *  ======== xdc/runtime/Assert.h ========
+ */
+
+#ifndef HOST_XDC_RUNTIME_ASSERT_H_
+#define HOST_XDC_RUNTIME_ASSERT_H_
+
+#include <assert.h>
+
+#define Assert_isTrue(expr, id) assert(expr)
+
+#endif /* HOST_XDC_RUNTIME_ASSERT_H_ */
@@ -0,0 +1,10 @@
+/*
+ *  ======== xdc/runtime/Diags.h ========
+ */
+
+#ifndef HOST_XDC_RUNTIME_DIAGS_H_
+#define HOST_XDC_RUNTIME_DIAGS_H_
+
+#define Diags_USER1             0x0100
+
+#endif /* HOST_XDC_RUNTIME_DIAGS_H_ */
@@ -0,0 +1,16 @@
+/*
+ *  ======== xdc/runtime/Error.h ========
+ */
+
+#ifndef HOST_XDC_RUNTIME_ERROR_H_
+#define HOST_XDC_RUNTIME_ERROR_H_
+
+#include <xdc/std.h>
+
+typedef struct Error_Block {
+    int             id;
+} Error_Block;
+
+#define Error_init(eb)          ((eb)->id = 0)
+
+#endif /* HOST_XDC_RUNTIME_ERROR_H_ */
@@ -0,0 +1,16 @@
+/*
+ *  ======== xdc/runtime/Log.h ========
+ *  Logging is compiled out on the host so it does not perturb the timing
+ *  measurements taken by the replay engine.
+ */
+
+#ifndef HOST_XDC_RUNTIME_LOG_H_
+#define HOST_XDC_RUNTIME_LOG_H_
+
+#include <xdc/runtime/Diags.h>
+
+#define Log_print0(mask, fmt)                   ((void)0)
+#define Log_print1(mask, fmt, a1)               ((void)(a1))
+#define Log_print2(mask, fmt, a1, a2)           ((void)(a1), (void)(a2))
+
+#endif /* HOST_XDC_RUNTIME_LOG_H_ */
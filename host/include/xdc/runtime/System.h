@@ -0,0 +1,14 @@
+/*
+ *  ======== xdc/runtime/System.h ========
+ */
+
+#ifndef HOST_XDC_RUNTIME_SYSTEM_H_
+#define HOST_XDC_RUNTIME_SYSTEM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define System_printf           printf
+#define System_abort(msg)       (fputs((msg), stderr), abort())
+
+#endif /* HOST_XDC_RUNTIME_SYSTEM_H_ */
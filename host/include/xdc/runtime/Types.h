@@ -0,0 +1,10 @@
+/*
+ *  ======== xdc/runtime/Types.h ========
+ */
+
+#ifndef HOST_XDC_RUNTIME_TYPES_H_
+#define HOST_XDC_RUNTIME_TYPES_H_
+
+#include <xdc/std.h>
+
+#endif /* HOST_XDC_RUNTIME_TYPES_H_ */
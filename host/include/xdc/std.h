@@ -0,0 +1,28 @@
+/*
+ *  ======== xdc/std.h ========
+ *  Host stand-in for the XDCtools base types used by the driver.
+ */
+
+#ifndef HOST_XDC_STD_H_
+#define HOST_XDC_STD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uintptr_t       UArg;
+typedef void            Void;
+typedef char            Char;
+typedef int             Int;
+typedef unsigned int    UInt;
+typedef uint32_t        UInt32;
+typedef bool            Bool;
+
+#ifndef TRUE
+#define TRUE            1
+#endif
+#ifndef FALSE
+#define FALSE           0
+#endif
+
+#endif /* HOST_XDC_STD_H_ */